@@ -0,0 +1,114 @@
+// ----------------------------------------------------------------------------
+// petalosim | PetAnalysisAccumulator.cc
+//
+// This class accumulates the histograms of the optical photon analyses
+// in plain arrays owned by each thread, so that filling them costs
+// a bin lookup. At the end of the run the sums of each bin (entries,
+// weights, squared weights and weighted values) are added to the
+// histograms of the G4 analysis manager, which writes them.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PetAnalysisAccumulator.h"
+
+#include <G4AnalysisManager.hh>
+
+#include <algorithm>
+
+
+PetAnalysisAccumulator& PetAnalysisAccumulator::Instance()
+{
+  static G4ThreadLocal PetAnalysisAccumulator* instance = nullptr;
+  if (!instance) instance = new PetAnalysisAccumulator();
+  return *instance;
+}
+
+
+PetAnalysisAccumulator::PetAnalysisAccumulator()
+{
+}
+
+
+PetAnalysisAccumulator::~PetAnalysisAccumulator()
+{
+}
+
+
+G4int PetAnalysisAccumulator::CreateH1(const G4String& name,
+                                       const G4String& title,
+                                       G4int n_bins, G4double x_min,
+                                       G4double x_max)
+{
+  G4int id = G4AnalysisManager::Instance()->CreateH1(name, title,
+                                                     n_bins, x_min, x_max);
+
+  if (id >= (G4int)histos_.size()) histos_.resize(id + 1);
+  H1& h = histos_[id];
+  h.id        = id;
+  h.x_min     = x_min;
+  h.x_max     = x_max;
+  h.inv_width = n_bins / (x_max - x_min);
+  h.entries.assign(n_bins + 2, 0);
+  h.sw  .assign(n_bins + 2, 0.);
+  h.sw2 .assign(n_bins + 2, 0.);
+  h.sxw .assign(n_bins + 2, 0.);
+  h.sx2w.assign(n_bins + 2, 0.);
+
+  return id;
+}
+
+
+void PetAnalysisAccumulator::FillH1(G4int id, G4double value, G4double weight)
+{
+  // Histograms not booked through the accumulator are ignored
+  if (id < 0 || id >= (G4int)histos_.size() || histos_[id].sw.empty())
+    return;
+
+  H1& h = histos_[id];
+  G4int n_bins = h.sw.size() - 2;
+
+  // Bin 0 is the underflow and the last one the overflow
+  G4int bin;
+  if (value < h.x_min)
+    bin = 0;
+  else if (value >= h.x_max)
+    bin = n_bins + 1;
+  else
+    bin = 1 + std::min(G4int((value - h.x_min) * h.inv_width), n_bins - 1);
+
+  h.entries[bin] += 1;
+  h.sw  [bin] += weight;
+  h.sw2 [bin] += weight * weight;
+  h.sxw [bin] += value * weight;
+  h.sx2w[bin] += value * value * weight;
+}
+
+
+void PetAnalysisAccumulator::Flush()
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+
+  for (auto& h : histos_) {
+    if (h.sw.empty()) continue;
+    auto histo = analysisManager->GetH1(h.id);
+    if (!histo) continue;
+
+    // The sums are added to those already in the histogram, so that
+    // the entries, errors, mean and RMS are the same as if every value
+    // had been filled in the histogram
+    for (size_t bin=0; bin<h.sw.size(); ++bin) {
+      if (h.entries[bin] == 0) continue;
+
+      histo->set_bin_content(bin,
+                             histo->bins_entries()[bin] + h.entries[bin],
+                             histo->bins_sum_w()[bin]   + h.sw[bin],
+                             histo->bins_sum_w2()[bin]  + h.sw2[bin],
+                             histo->bins_sum_xw()[bin][0]  + h.sxw[bin],
+                             histo->bins_sum_x2w()[bin][0] + h.sx2w[bin]);
+
+      h.entries[bin] = 0;
+      h.sw[bin] = h.sw2[bin] = h.sxw[bin] = h.sx2w[bin] = 0.;
+    }
+  }
+}
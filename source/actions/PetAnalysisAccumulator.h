@@ -0,0 +1,53 @@
+// ----------------------------------------------------------------------------
+// petalosim | PetAnalysisAccumulator.h
+//
+// This class accumulates the histograms of the optical photon analyses
+// in plain arrays owned by each thread, so that filling them costs
+// a bin lookup. At the end of the run the sums of each bin (entries,
+// weights, squared weights and weighted values) are added to the
+// histograms of the G4 analysis manager, which writes them.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PET_ANALYSIS_ACCUMULATOR_H
+#define PET_ANALYSIS_ACCUMULATOR_H
+
+#include <globals.hh>
+
+#include <vector>
+
+class PetAnalysisAccumulator
+{
+public:
+  /// Return the instance of the current thread
+  static PetAnalysisAccumulator& Instance();
+
+  /// Book a histogram in the G4 analysis manager and its accumulator,
+  /// returning its ID
+  G4int CreateH1(const G4String& name, const G4String& title,
+                 G4int n_bins, G4double x_min, G4double x_max);
+
+  void FillH1(G4int id, G4double value, G4double weight = 1.);
+
+  /// Add the accumulated sums to the histograms of the G4 analysis manager
+  /// and reset the accumulators
+  void Flush();
+
+private:
+  PetAnalysisAccumulator();
+  ~PetAnalysisAccumulator();
+
+  /// Sums of each bin, including the underflow (first) and
+  /// the overflow (last), as kept by the G4 histograms
+  struct H1 {
+    G4int id;
+    G4double x_min, x_max, inv_width;
+    std::vector<unsigned int> entries;
+    std::vector<G4double> sw, sw2, sxw, sx2w;
+  };
+
+  std::vector<H1> histos_; ///< Indexed by histogram ID
+};
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "PetAnalysisEventAction.h"
 #include "PetaloPersistencyManager.h"
+#include "PerformanceMonitor.h"
 
 #include "nexus/Trajectory.h"
 #include "nexus/FactoryBase.h"
@@ -58,6 +59,8 @@ PetAnalysisEventAction::~PetAnalysisEventAction()
 
 void PetAnalysisEventAction::BeginOfEventAction(const G4Event * /*event*/)
 {
+  PerformanceMonitor::Instance().BeginEvent();
+
   // Print out event number info
   if ((nevt_ % nupdate_) == 0)
   {
@@ -70,6 +73,7 @@ void PetAnalysisEventAction::BeginOfEventAction(const G4Event * /*event*/)
 void PetAnalysisEventAction::EndOfEventAction(const G4Event *event)
 {
   nevt_++;
+  PerformanceMonitor::Instance().EndEvent();
 
   // Determine whether total energy deposit in ionization sensitive
   // detectors is above threshold
@@ -10,6 +10,7 @@
 // ----------------------------------------------------------------------------
 
 #include "PetAnalysisRunAction.h"
+#include "PetAnalysisAccumulator.h"
 
 #include "nexus/FactoryBase.h"
 
@@ -32,12 +33,13 @@ PetAnalysisRunAction::PetAnalysisRunAction(): G4UserRunAction(),
   auto analysisManager = G4AnalysisManager::Instance();
   analysisManager->SetDefaultFileType("csv");
 
-  // Book 1D histograms
-  analysisManager->CreateH1("CherLambda","Wavelength of Cherenkov photons (nm)", 1000, 0, 1500.); // histo ID = 0
-  analysisManager->CreateH1("ScintLambda","Wavelength of scintillation photons (nm)", 1000, 0, 800.); // histo ID = 1
-  analysisManager->CreateH1("ScintillationTime", "Scintillation time (ps)", 8000, 0, 40000.); // histo ID = 2
-  analysisManager->CreateH1("PhVelocity", "Velocity of scintillation photons (mm/ps)", 1000, 0, 0.4); // histo ID = 3
-  analysisManager->CreateH1("PhLambdaDet", "Wavelength of detected photons (nm)", 1000, 0, 1500.); // histo ID = 4
+  // Book 1D histograms, filled through the accumulator of each thread
+  auto& accumulator = PetAnalysisAccumulator::Instance();
+  accumulator.CreateH1("CherLambda","Wavelength of Cherenkov photons (nm)", 1000, 0, 1500.); // histo ID = 0
+  accumulator.CreateH1("ScintLambda","Wavelength of scintillation photons (nm)", 1000, 0, 800.); // histo ID = 1
+  accumulator.CreateH1("ScintillationTime", "Scintillation time (ps)", 8000, 0, 40000.); // histo ID = 2
+  accumulator.CreateH1("PhVelocity", "Velocity of scintillation photons (mm/ps)", 1000, 0, 0.4); // histo ID = 3
+  accumulator.CreateH1("PhLambdaDet", "Wavelength of detected photons (nm)", 1000, 0, 1500.); // histo ID = 4
 
   /*
   // Example of how to book 2D histograms
@@ -92,6 +94,7 @@ void PetAnalysisRunAction::EndOfRunAction(const G4Run* run)
 
   auto analysisManager = G4AnalysisManager::Instance();
 
+  PetAnalysisAccumulator::Instance().Flush();
   analysisManager->Write();
   analysisManager->CloseFile();
 }
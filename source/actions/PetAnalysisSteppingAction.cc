@@ -12,6 +12,7 @@
 // ----------------------------------------------------------------------------
 
 #include "PetAnalysisSteppingAction.h"
+#include "PetAnalysisAccumulator.h"
 
 #include "nexus/FactoryBase.h"
 
@@ -22,7 +23,10 @@
 #include <G4OpBoundaryProcess.hh>
 #include <G4Electron.hh>
 #include <G4GenericMessenger.hh>
-#include <G4AnalysisManager.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4AutoLock.hh>
+
+#include <map>
 
 namespace nexus {}
 using namespace nexus;
@@ -30,27 +34,63 @@ using namespace CLHEP;
 
 REGISTER_CLASS(PetAnalysisSteppingAction, G4UserSteppingAction)
 
-PetAnalysisSteppingAction::PetAnalysisSteppingAction(): G4UserSteppingAction()
+namespace {
+  G4Mutex countsMutex = G4MUTEX_INITIALIZER;
+  G4int n_instances = 0;
+  G4int total_detected = 0;
+  G4int total_not_det = 0;
+  std::vector<G4int> total_counts;
+  std::vector<G4String> total_names;
+}
+
+PetAnalysisSteppingAction::PetAnalysisSteppingAction(): G4UserSteppingAction(),
+                                                        boundary_(nullptr)
 {
   detected = 0;
   not_det = 0;
+
+  G4AutoLock lock(&countsMutex);
+  n_instances++;
 }
 
 
 
 PetAnalysisSteppingAction::~PetAnalysisSteppingAction()
 {
-  G4cout << "Detected photons = " << detected << G4endl;
-  G4cout << "Non detected photons = " << not_det << G4endl;
-
-  G4double total_counts = 0;
-  detectorCounts::iterator it = my_counts.begin();
-  while (it != my_counts.end()) {
-    G4cout << "Detector " << it->first << ": " << it->second << " counts" << G4endl;
-    total_counts += it->second;
-    it ++;
+  // The counts of all the instances (one per thread) are added up,
+  // and the last instance to be destroyed prints them
+  G4AutoLock lock(&countsMutex);
+
+  total_detected += detected;
+  total_not_det  += not_det;
+  if (total_counts.size() < my_counts.size()) {
+    total_counts.resize(my_counts.size(), 0);
+    total_names.resize(my_counts.size());
+  }
+  for (size_t i=0; i<my_counts.size(); ++i) {
+    if (my_counts[i] == 0) continue;
+    total_counts[i] += my_counts[i];
+    total_names[i]   = my_names[i];
+  }
+
+  if (--n_instances > 0) return;
+
+  G4cout << "Detected photons = " << total_detected << G4endl;
+  G4cout << "Non detected photons = " << total_not_det << G4endl;
+
+  // Volumes with the same name are counted together
+  std::map<G4String, G4int> counts_per_name;
+  for (size_t i=0; i<total_counts.size(); ++i) {
+    if (total_counts[i] > 0)
+      counts_per_name[total_names[i]] += total_counts[i];
+  }
+
+  G4double tot = 0;
+  for (const auto& [name, counts] : counts_per_name) {
+    G4cout << "Detector " << name << ": " << counts << " counts" << G4endl;
+    tot += counts;
   }
-  G4cout << "TOTAL COUNTS: " << total_counts << G4endl;
+  G4cout << "TOTAL COUNTS: " << tot << G4endl;
 }
 
 
@@ -65,26 +105,21 @@ void PetAnalysisSteppingAction::UserSteppingAction(const G4Step* step)
 
   G4StepPoint* point1 = step->GetPreStepPoint();
   G4StepPoint* point2 = step->GetPostStepPoint();
-  G4TouchableHandle touch1 = point1->GetTouchableHandle();
-  G4TouchableHandle touch2 = point2->GetTouchableHandle();
-  G4String vol1name = touch1->GetVolume()->GetName();
-  G4String vol2name = touch2->GetVolume()->GetName();
   //G4Track* track = step->GetTrack();
 
   //G4String proc_name = step->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
   //G4int copy_no = step->GetPostStepPoint()->GetTouchable()->GetReplicaNumber(1);
 
   // Retrieve the pointer to the optical boundary process.
-  // We do this only once per run defining our local pointer as static.
-  static G4OpBoundaryProcess* boundary = 0;
-
-  if (!boundary) { // the pointer is not defined yet
+  // We do this only once, and keep it in the action so that
+  // each thread uses its own process.
+  if (!boundary_) { // the pointer is not defined yet
     // Get the list of processes defined for the optical photon
     // and loop through it to find the optical boundary process.
     G4ProcessVector* pv = pdef->GetProcessManager()->GetProcessList();
     for (size_t i=0; i<pv->size(); i++) {
       if ((*pv)[i]->GetProcessName() == "OpBoundary") {
-	boundary = (G4OpBoundaryProcess*) (*pv)[i];
+	boundary_ = (G4OpBoundaryProcess*) (*pv)[i];
 	break;
       }
     }
@@ -93,7 +128,7 @@ void PetAnalysisSteppingAction::UserSteppingAction(const G4Step* step)
   if (step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary) {
 
     // if boundary->GetStatus() == 2 in SiPMpet refraction takes place
-    if (boundary->GetStatus() == Detection) {
+    if (boundary_->GetStatus() == Detection) {
 	detected = detected + 1;
 	double distance =
 	  std::pow(point2->GetPosition().getX() - point1->GetPosition().getX(), 2) +
@@ -101,15 +136,18 @@ void PetAnalysisSteppingAction::UserSteppingAction(const G4Step* step)
 	distance = std::sqrt(distance);
 	G4double lambda = h_Planck*c_light/step->GetTrack()->GetKineticEnergy()/nanometer;
 
-        auto analysisManager = G4AnalysisManager::Instance();
-	analysisManager->FillH1(4, lambda);
-
-	G4String detector_name = step->GetPostStepPoint()->GetTouchableHandle()->GetVolume()->GetName();
-	//G4cout << "##### Sensitive Volume: " << detector_name << G4endl;
-
-	detectorCounts::iterator it = my_counts.find(detector_name);
-	if (it != my_counts.end()) my_counts[it->first] += 1;
-	else my_counts[detector_name] = 1;
+	PetAnalysisAccumulator::Instance().FillH1(4, lambda);
+
+	// Volumes are identified by their instance ID, cheaper than their name,
+	// which is only kept the first time the volume is found
+	G4VPhysicalVolume* det = point2->GetTouchableHandle()->GetVolume();
+	G4int id = det->GetInstanceID();
+	if (id >= (G4int)my_counts.size()) {
+	  my_counts.resize(id + 1, 0);
+	  my_names.resize(id + 1);
+	}
+	if (my_counts[id] == 0) my_names[id] = det->GetName();
+	my_counts[id] += 1;
       } else {
 	not_det = not_det + 1;
       }
@@ -22,6 +22,7 @@
 
 class G4Step;
 class G4GenericMessenger;
+class G4OpBoundaryProcess;
 
 class PetAnalysisSteppingAction : public G4UserSteppingAction
 {
@@ -34,11 +35,15 @@ public:
   virtual void UserSteppingAction(const G4Step *);
 
 private:
+  /// Optical boundary process, retrieved at the first optical photon step
+  G4OpBoundaryProcess* boundary_;
+
   G4int detected;
   G4int not_det;
 
-  typedef std::map<G4String, int> detectorCounts;
-  detectorCounts my_counts;
+  /// Detected photons per physical volume, indexed by its instance ID
+  std::vector<G4int> my_counts;
+  std::vector<G4String> my_names;
 };
 
 #endif
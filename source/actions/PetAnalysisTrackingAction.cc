@@ -8,6 +8,8 @@
 // ----------------------------------------------------------------------------
 
 #include "PetAnalysisTrackingAction.h"
+#include "PetAnalysisAccumulator.h"
+#include "PerformanceMonitor.h"
 
 #include "nexus/Trajectory.h"
 #include "nexus/TrajectoryMap.h"
@@ -20,7 +22,7 @@
 #include <G4OpticalPhoton.hh>
 #include <G4Electron.hh>
 #include <G4GenericMessenger.hh>
-#include <G4AnalysisManager.hh>
+#include <G4OpProcessSubType.hh>
 
 
 using namespace nexus;
@@ -45,18 +47,25 @@ void PetAnalysisTrackingAction::PreUserTrackingAction(const G4Track* track)
   //   G4cout << track->GetCreatorProcess()->GetProcessName()  << G4endl;
   // Do nothing if the track is an optical photon
 
-  if (track->GetDefinition() == G4OpticalPhoton::Definition()) {
+  if (track->GetDefinition() == G4OpticalPhoton::Definition())
+    PerformanceMonitor::Instance().CountOpticalPhoton();
 
-    auto analysisManager = G4AnalysisManager::Instance();
+  if (track->GetDefinition() == G4OpticalPhoton::Definition() &&
+      track->GetCreatorProcess()) {
 
-    if (track->GetCreatorProcess()->GetProcessName() == "Cerenkov") {
+    auto& accumulator = PetAnalysisAccumulator::Instance();
+
+    // Processes are identified by their subtype, cheaper than their name
+    G4int subtype = track->GetCreatorProcess()->GetProcessSubType();
+
+    if (subtype == fCerenkov) {
       //track->CalculateVelocityForOpticalPhoton()
-      analysisManager->FillH1(0, h_Planck*c_light/track->GetKineticEnergy()/nanometer);
+      accumulator.FillH1(0, h_Planck*c_light/track->GetKineticEnergy()/nanometer);
     }
-    else if (track->GetCreatorProcess()->GetProcessName() == "Scintillation") {
-      analysisManager->FillH1(1, h_Planck*c_light/track->GetKineticEnergy()/nanometer);
-      analysisManager->FillH1(2, track->GetGlobalTime()/picosecond);
-      analysisManager->FillH1(3, track->CalculateVelocityForOpticalPhoton()/mm*picosecond);
+    else if (subtype == fScintillation) {
+      accumulator.FillH1(1, h_Planck*c_light/track->GetKineticEnergy()/nanometer);
+      accumulator.FillH1(2, track->GetGlobalTime()/picosecond);
+      accumulator.FillH1(3, track->CalculateVelocityForOpticalPhoton()/mm*picosecond);
     }
   }
 
@@ -2,23 +2,130 @@
 // petalosim | PetNESTStackingAction.cc
 //
 // This is the stacking action needed to use NEST.
+// Optionally, the thermal electrons produced by NEST are not tracked:
+// they are drifted to the wires with a parametric model, which includes
+// diffusion and losses by attachment.
 //
 // The PETALO Collaboration
 // ----------------------------------------------------------------------------
 
 #include "PetNESTStackingAction.h"
+#include "ChargeSD.h"
 
 #include "nexus/FactoryBase.h"
 
+#include <NESTProc.hh>
+
+#include <G4GenericMessenger.hh>
+#include <G4SDManager.hh>
+#include <G4Track.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <cmath>
+
 
 REGISTER_CLASS(PetNESTStackingAction, G4UserStackingAction)
 
-PetNESTStackingAction::PetNESTStackingAction(): NESTStackingAction()
+PetNESTStackingAction::PetNESTStackingAction(): NESTStackingAction(),
+                                                param_drift_(false),
+                                                sd_name_("/WIRE/ChargeDet"),
+                                                charge_sd_(nullptr),
+                                                drift_vel_(2.),
+                                                transv_diff_(0.23),
+                                                long_diff_(0.16),
+                                                lifetime_(0.)
 {
+  msg_ = new G4GenericMessenger(this, "/Actions/PetNESTStackingAction/");
+
+  msg_->DeclareProperty("parametric_drift", param_drift_,
+                        "If true, thermal electrons are drifted to the wires "
+                        "with a parametric model instead of being tracked.");
+
+  msg_->DeclareProperty("charge_sd", sd_name_,
+                        "Name of the sensitive detector of the wires.");
+
+  G4GenericMessenger::Command& vel_cmd =
+    msg_->DeclareProperty("drift_velocity", drift_vel_,
+                          "Drift velocity of the electrons, in mm/us.");
+  vel_cmd.SetParameterName("drift_velocity", false);
+  vel_cmd.SetRange("drift_velocity>0.");
+
+  G4GenericMessenger::Command& transv_cmd =
+    msg_->DeclareProperty("transv_diffusion", transv_diff_,
+                          "Transverse diffusion, in mm/sqrt(cm).");
+  transv_cmd.SetParameterName("transv_diffusion", false);
+  transv_cmd.SetRange("transv_diffusion>=0.");
+
+  G4GenericMessenger::Command& long_cmd =
+    msg_->DeclareProperty("long_diffusion", long_diff_,
+                          "Longitudinal diffusion, in mm/sqrt(cm).");
+  long_cmd.SetParameterName("long_diffusion", false);
+  long_cmd.SetRange("long_diffusion>=0.");
+
+  G4GenericMessenger::Command& life_cmd =
+    msg_->DeclarePropertyWithUnit("lifetime", "microsecond", lifetime_,
+                                  "Electron lifetime. Zero means no attachment.");
+  life_cmd.SetParameterName("lifetime", false);
+  life_cmd.SetRange("lifetime>=0.");
 }
 
 
 
 PetNESTStackingAction::~PetNESTStackingAction()
 {
+  delete msg_;
+}
+
+
+
+G4ClassificationOfNewTrack
+PetNESTStackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  if (param_drift_ &&
+      track->GetDefinition() == NEST::NESTThermalElectron::Definition()) {
+    DriftElectron(track->GetPosition(), track->GetGlobalTime());
+    return fKill;
+  }
+
+  return NESTStackingAction::ClassifyNewTrack(track);
+}
+
+
+
+void PetNESTStackingAction::DriftElectron(const G4ThreeVector& position,
+                                          G4double time)
+{
+  if (!charge_sd_) {
+    charge_sd_ = dynamic_cast<ChargeSD*>
+      (G4SDManager::GetSDMpointer()->FindSensitiveDetector(sd_name_, false));
+    if (!charge_sd_) {
+      G4Exception("[PetNESTStackingAction]", "DriftElectron()", FatalException,
+                  ("Charge sensitive detector " + sd_name_ + " not found.").c_str());
+    }
+  }
+
+  // The field is radial: electrons created beyond the wires are lost
+  G4double wire_radius  = charge_sd_->GetWireRadius();
+  G4double drift_length = wire_radius - position.perp();
+  if (drift_length < 0.) return;
+
+  G4double velocity   = drift_vel_ * mm/microsecond;
+  G4double drift_time = drift_length / velocity;
+  if (lifetime_ > 0. && G4UniformRand() > std::exp(-drift_time / lifetime_))
+    return;
+
+  G4double sigma_t = transv_diff_ * mm * std::sqrt(drift_length / cm);
+  G4double sigma_l = long_diff_   * mm * std::sqrt(drift_length / cm);
+
+  G4double z = position.z() + G4RandGauss::shoot(0., sigma_t);
+  if (std::abs(z) > charge_sd_->GetWireHalfLength()) return;
+
+  G4double phi = position.phi() + G4RandGauss::shoot(0., sigma_t) / wire_radius;
+  G4ThreeVector end(wire_radius * std::cos(phi), wire_radius * std::sin(phi), z);
+
+  G4double arrival_time =
+    time + (drift_length + G4RandGauss::shoot(0., sigma_l)) / velocity;
+
+  charge_sd_->AddCharge(end, arrival_time);
 }
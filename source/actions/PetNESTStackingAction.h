@@ -2,6 +2,9 @@
 // petalosim | PetNESTStackingAction.h
 //
 // This is the stacking action needed to use NEST.
+// Optionally, the thermal electrons produced by NEST are not tracked:
+// they are drifted to the wires with a parametric model, which includes
+// diffusion and losses by attachment.
 //
 // The PETALO Collaboration
 // ----------------------------------------------------------------------------
@@ -10,9 +13,13 @@
 #define PET_NEST_STACKING_ACTION_H
 
 #include <G4UserStackingAction.hh>
+#include <G4ThreeVector.hh>
 
 #include <NESTStackingAction.hh>
 
+class G4GenericMessenger;
+class ChargeSD;
+
 // General-purpose user stacking action
 
 class PetNESTStackingAction : public NESTStackingAction
@@ -23,6 +30,23 @@ public:
   /// Destructor
   ~PetNESTStackingAction();
 
+  G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
+
+private:
+  /// Drift a thermal electron radially to the ring of wires
+  /// and add its charge to the corresponding wire
+  void DriftElectron(const G4ThreeVector& position, G4double time);
+
+  G4GenericMessenger* msg_;
+
+  G4bool param_drift_; ///< If true, thermal electrons are not tracked
+  G4String sd_name_; ///< Name of the charge sensitive detector
+  ChargeSD* charge_sd_;
+
+  G4double drift_vel_; ///< Drift velocity, in mm/us
+  G4double transv_diff_; ///< Transverse diffusion, in mm/sqrt(cm)
+  G4double long_diff_; ///< Longitudinal diffusion, in mm/sqrt(cm)
+  G4double lifetime_; ///< Electron lifetime, zero means no attachment
 };
 
 #endif
@@ -38,6 +38,7 @@ selected_volumes_()
         (G4VPersistencyManager::GetPersistencyManager());
 
   pm->StoreSteps(true);
+  pm->SetStepSource(this);
 
 }
 
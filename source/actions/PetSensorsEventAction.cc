@@ -9,6 +9,7 @@
 
 #include "PetSensorsEventAction.h"
 #include "PetaloPersistencyManager.h"
+#include "PerformanceMonitor.h"
 #include "ToFSD.h"
 
 #include "nexus/Trajectory.h"
@@ -60,6 +61,8 @@ PetSensorsEventAction::~PetSensorsEventAction()
 
 void PetSensorsEventAction::BeginOfEventAction(const G4Event* /*event*/)
 {
+  PerformanceMonitor::Instance().BeginEvent();
+
   // Print out event number info
   if ((nevt_ % nupdate_) == 0)
   {
@@ -72,6 +75,7 @@ void PetSensorsEventAction::BeginOfEventAction(const G4Event* /*event*/)
 void PetSensorsEventAction::EndOfEventAction(const G4Event* event)
 {
   nevt_++;
+  PerformanceMonitor::Instance().EndEvent();
 
   // Determine whether total energy deposit in ionization sensitive
   // detectors is above threshold
@@ -103,26 +107,28 @@ void PetSensorsEventAction::EndOfEventAction(const G4Event* event)
     G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
     G4HCtable* hct = sdmgr->GetHCtable();
 
-    // Get only the PetSensorHitsCollection --> 1
-    G4String hcname = hct->GetHCname(1);
-    G4String sdname = hct->GetSDname(1);
-    int hcid = sdmgr->GetCollectionID(sdname+"/"+hcname);
+    // Sum the charge of all the sensor hits collections, which are
+    // looked up by name since their position in the table depends on
+    // the order in which the sensitive detectors are created
+    for (int i=0; hce && i<hct->entries(); i++) {
+      G4String hcname = hct->GetHCname(i);
+      if (hcname != ToFSD::GetCollectionUniqueName()) continue;
 
-    if (hcname == ToFSD::GetCollectionUniqueName()){
-      G4VHitsCollection* SensHits = hce->GetHC(hcid);
+      G4String sdname = hct->GetSDname(i);
+      int hcid = sdmgr->GetCollectionID(sdname+"/"+hcname);
       PetSensorHitsCollection* hits =
-        dynamic_cast<PetSensorHitsCollection*>(SensHits);
-      if (!hits) return;
-      for (size_t i=0; i<hits->entries(); i++) {
-        PetSensorHit* hit = dynamic_cast<PetSensorHit*>(hits->GetHit(i));
+        dynamic_cast<PetSensorHitsCollection*>(hce->GetHC(hcid));
+      if (!hits) continue;
+      for (size_t j=0; j<hits->entries(); j++) {
+        PetSensorHit* hit = dynamic_cast<PetSensorHit*>(hits->GetHit(j));
         if (!hit) continue;
 
-        amplitude += hit->GetDetPhotons();
+        amplitude += hit->GetWeightedPhotons();
       }
+    }
 
-      if (amplitude>min_charge_){
-        charge_above_th = true;
-      }
+    if (amplitude>min_charge_){
+      charge_above_th = true;
     }
 
     PetaloPersistencyManager* pm =
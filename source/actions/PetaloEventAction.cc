@@ -9,6 +9,7 @@
 
 #include "PetaloEventAction.h"
 #include "PetaloPersistencyManager.h"
+#include "PerformanceMonitor.h"
 
 #include "nexus/Trajectory.h"
 #include "nexus/FactoryBase.h"
@@ -57,6 +58,8 @@ PetaloEventAction::~PetaloEventAction()
 
 void PetaloEventAction::BeginOfEventAction(const G4Event* /*event*/)
 {
+  PerformanceMonitor::Instance().BeginEvent();
+
   // Print out event number info
   if ((nevt_ % nupdate_) == 0)
   {
@@ -69,6 +72,7 @@ void PetaloEventAction::BeginOfEventAction(const G4Event* /*event*/)
 void PetaloEventAction::EndOfEventAction(const G4Event* event)
 {
   nevt_++;
+  PerformanceMonitor::Instance().EndEvent();
 
   // Determine whether total energy deposit in ionization sensitive
   // detectors is above threshold
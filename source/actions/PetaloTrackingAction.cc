@@ -10,6 +10,7 @@
 // ----------------------------------------------------------------------------
 
 #include "PetaloTrackingAction.h"
+#include "PerformanceMonitor.h"
 
 #include "nexus/Trajectory.h"
 #include "nexus/TrajectoryMap.h"
@@ -43,6 +44,9 @@ PetaloTrackingAction::~PetaloTrackingAction()
 
 void PetaloTrackingAction::PreUserTrackingAction(const G4Track* track)
 {
+  if (track->GetDefinition() == G4OpticalPhoton::Definition())
+    PerformanceMonitor::Instance().CountOpticalPhoton();
+
   // Do nothing if the track is an optical photon
   if (track->GetDefinition() == G4OpticalPhoton::Definition() ||
       track->GetDefinition() == NEST::NESTThermalElectron::Definition()) {
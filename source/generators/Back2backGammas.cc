@@ -5,12 +5,16 @@
 // The non-collinearity of the momenta and the Doppler shift of the energy
 // are taken into account. The first gamma is generated with random direction,
 // by default. However, it is possible to specify a limited solid angle.
+// Optionally, the annihilation point is displaced from the decay point
+// by a distance sampled from tabulated positron range distributions,
+// and a de-excitation gamma is emitted from the decay point.
 //
 // The PETALO Collaboration
 // ----------------------------------------------------------------------------
 
 #include "Back2backGammas.h"
 #include "PetaloUtils.h"
+#include "PositronRangeTable.h"
 
 #include "nexus/RandomUtils.h"
 #include "nexus/DetectorConstruction.h"
@@ -22,6 +26,11 @@
 #include <G4RunManager.hh>
 #include <G4ParticleTable.hh>
 #include <G4RandomDirection.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
 #include <Randomize.hh>
 
 using namespace CLHEP;
@@ -31,7 +40,9 @@ REGISTER_CLASS(Back2backGammas, G4VPrimaryGenerator)
 
 Back2backGammas::Back2backGammas(): geom_(0), costheta_min_(-1.),
                                     costheta_max_(1.),
-                                    phi_min_(0.), phi_max_(2.*pi)
+                                    phi_min_(0.), phi_max_(2.*pi),
+                                    range_table_(nullptr), range_material_(""),
+                                    prompt_gamma_energy_(0.)
 {
   //G4cout << "Limits = " << std::numeric_limits<unsigned int>::max() << G4endl;
   msg_ = new G4GenericMessenger(this, "/Generator/Back2back/",
@@ -49,6 +60,22 @@ Back2backGammas::Back2backGammas(): geom_(0), costheta_min_(-1.),
   msg_->DeclareProperty("max_phi", phi_max_,
                         "Maximum phi for the direction of the particle.");
 
+  msg_->DeclareMethod("positron_range_file",
+                      &Back2backGammas::SetPositronRangeFile,
+                      "File with the tabulated positron range distributions. "
+                      "If set, the gammas are emitted from the annihilation point.");
+  msg_->DeclareProperty("positron_range_material", range_material_,
+                        "Material used to sample the positron range. "
+                        "If not set, the material at the decay point is used.");
+
+  G4GenericMessenger::Command& prompt_cmd =
+    msg_->DeclarePropertyWithUnit("prompt_gamma_energy", "keV",
+                                  prompt_gamma_energy_,
+                                  "Energy of the de-excitation gamma emitted "
+                                  "from the decay point (e.g. 1274.5 keV for Na22).");
+  prompt_cmd.SetParameterName("prompt_gamma_energy", false);
+  prompt_cmd.SetRange("prompt_gamma_energy>=0.");
+
   DetectorConstruction* detconst =
     (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
@@ -56,6 +83,7 @@ Back2backGammas::Back2backGammas(): geom_(0), costheta_min_(-1.),
 
 Back2backGammas::~Back2backGammas()
 {
+  delete range_table_;
 }
 
 void Back2backGammas::GeneratePrimaryVertex(G4Event* evt)
@@ -75,6 +103,18 @@ void Back2backGammas::GeneratePrimaryVertex(G4Event* evt)
 
   G4ThreeVector position = geom_->GenerateVertex(region_);
   G4double time = 0.;
+
+  if (prompt_gamma_energy_ > 0.) {
+    auto prompt_vertex = new G4PrimaryVertex(position, time);
+    auto p = prompt_gamma_energy_ * G4RandomDirection();
+    prompt_vertex->SetPrimary(new G4PrimaryParticle(gamma, p.x(), p.y(), p.z()));
+    evt->AddPrimaryVertex(prompt_vertex);
+  }
+
+  // The positron is assumed to travel in the material of the decay point
+  if (range_table_)
+    position += range_table_->SampleDisplacement(PositronMaterial(position));
+
   auto vertex = new G4PrimaryVertex(position, time);
 
   vertex->SetPrimary(new G4PrimaryParticle(gamma,  p1.x(),  p1.y(),  p1.z()));
@@ -82,3 +122,23 @@ void Back2backGammas::GeneratePrimaryVertex(G4Event* evt)
 
   evt->AddPrimaryVertex(vertex);
 }
+
+
+void Back2backGammas::SetPositronRangeFile(G4String filename)
+{
+  if (!range_table_) range_table_ = new PositronRangeTable();
+  range_table_->Read(filename);
+}
+
+
+G4String Back2backGammas::PositronMaterial(const G4ThreeVector& position) const
+{
+  if (range_material_ != "") return range_material_;
+
+  G4Navigator* navigator = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking();
+  G4VPhysicalVolume* volume =
+    navigator->LocateGlobalPointAndSetup(position, nullptr, false);
+
+  return volume->GetLogicalVolume()->GetMaterial()->GetName();
+}
@@ -5,6 +5,9 @@
 // The non-collinearity of the momenta and the Doppler shift of the energy
 // are taken into account. The first gamma is generated with random direction,
 // by default. However, it is possible to specify a limited solid angle.
+// Optionally, the annihilation point is displaced from the decay point
+// by a distance sampled from tabulated positron range distributions,
+// and a de-excitation gamma is emitted from the decay point.
 //
 // The PETALO Collaboration
 // ----------------------------------------------------------------------------
@@ -16,6 +19,7 @@
 
 class G4Event;
 class G4GenericMessenger;
+class PositronRangeTable;
 
 namespace nexus { class GeometryBase; }
 
@@ -30,6 +34,10 @@ public:
   void GeneratePrimaryVertex(G4Event* evt);
   
 private:
+
+  void SetPositronRangeFile(G4String filename);
+  /// Name of the material where the positron travels
+  G4String PositronMaterial(const G4ThreeVector& position) const;
   
   G4GenericMessenger* msg_;
   const nexus::GeometryBase* geom_;
@@ -40,6 +48,11 @@ private:
   G4double costheta_max_;
   G4double phi_min_;
   G4double phi_max_;
+
+  PositronRangeTable* range_table_; ///< Positron range distributions
+  G4String range_material_; ///< If empty, taken from the decay point
+
+  G4double prompt_gamma_energy_; ///< Zero means no de-excitation gamma
 };
 
 //}// end namespace nexus
@@ -34,7 +34,8 @@ REGISTER_CLASS(LXeScintillationGenerator, G4VPrimaryGenerator)
 
 
 LXeScintillationGenerator::LXeScintillationGenerator() :
-  G4VPrimaryGenerator(), msg_(0), geom_(0), nphotons_(100000)
+  G4VPrimaryGenerator(), msg_(0), geom_(0), nphotons_(100000),
+  spectrum_integral_(nullptr)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/LXeScintGenerator/",
     "Control commands of LXe scintillation generator.");
@@ -53,6 +54,7 @@ LXeScintillationGenerator::LXeScintillationGenerator() :
 LXeScintillationGenerator::~LXeScintillationGenerator()
 {
   delete msg_;
+  delete spectrum_integral_;
 }
 
 
@@ -67,15 +69,16 @@ void LXeScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
 
   // Energy is sampled from integral (like it is
   // done in G4Scintillation)
-  G4MaterialPropertiesTable* mpt = opticalprops::LXe();
-  // Using fast or slow component here is irrelevant, since we're not using
-  // time and they're the same in energy.
-  G4MaterialPropertyVector* spectrum =
-    mpt->GetProperty("SCINTILLATIONCOMPONENT1");
-  G4PhysicsOrderedFreeVector* spectrum_integral =
-      new G4PhysicsOrderedFreeVector();
-  ComputeCumulativeDistribution(*spectrum, *spectrum_integral);
-  G4double sc_max = spectrum_integral->GetMaxValue();
+  if (!spectrum_integral_) {
+    G4MaterialPropertiesTable* mpt = opticalprops::LXe();
+    // Using fast or slow component here is irrelevant, since we're not using
+    // time and they're the same in energy.
+    G4MaterialPropertyVector* spectrum =
+      mpt->GetProperty("SCINTILLATIONCOMPONENT1");
+    spectrum_integral_ = new G4PhysicsOrderedFreeVector();
+    ComputeCumulativeDistribution(*spectrum, *spectrum_integral_);
+  }
+  G4double sc_max = spectrum_integral_->GetMaxValue();
 
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
@@ -86,7 +89,7 @@ void LXeScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
       G4ThreeVector momentum_direction_ = G4RandomDirection();
       // Determine photon energy
       G4double sc_value = G4UniformRand()*sc_max;
-      G4double pmod = spectrum_integral->GetEnergy(sc_value);
+      G4double pmod = spectrum_integral_->GetEnergy(sc_value);
 
       G4double px = pmod * momentum_direction_.x();
       G4double py = pmod * momentum_direction_.y();
@@ -43,6 +43,9 @@ namespace nexus { class GeometryBase; }
     G4String region_;
     G4int    nphotons_;
 
+    /// Integral of the LXe scintillation spectrum, computed at the first event
+    G4PhysicsOrderedFreeVector* spectrum_integral_;
+
   };
 
 #endif
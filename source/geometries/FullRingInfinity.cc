@@ -10,9 +10,17 @@
 #include "FullRingInfinity.h"
 #include "SiPMpetVUV.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "PetIonizationSD.h"
 #include "ChargeSD.h"
 #include "JaszczakPhantom.h"
+#include "VoxelPhantom.h"
+#include "PhotonSinkSD.h"
+#include "PetaloPersistencyManager.h"
+#include "GeometryCache.h"
+#include "RegionSettings.h"
+#include "InitProfiler.h"
+#include "VoxelPointSampler.h"
 
 #include "nexus/SpherePointSampler.h"
 #include "nexus/Visibilities.h"
@@ -26,7 +34,9 @@
 #include <G4Orb.hh>
 #include <G4Material.hh>
 #include <G4LogicalVolume.hh>
+#include <G4LogicalVolumeStore.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVReplica.hh>
 #include <G4NistManager.hh>
 #include <G4VisAttributes.hh>
 #include <G4LogicalVolume.hh>
@@ -37,6 +47,9 @@
 #include <Randomize.hh>
 #include <G4UnionSolid.hh>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace nexus;
 
 REGISTER_CLASS(FullRingInfinity, GeometryBase)
@@ -49,6 +62,7 @@ FullRingInfinity::FullRingInfinity() :
   instr_faces_(2),
   charge_det_(false),
   separators_(false),
+  replica_sensors_(false),
   wire_pitch_(4. * mm),
   wire_time_bin_(1.*microsecond),
   chdet_thickn_(1.*micrometer),
@@ -68,14 +82,19 @@ FullRingInfinity::FullRingInfinity() :
   n_sep_phi_(10),
   specific_vertex_{},
   phantom_(false),
-  pt_Lx_(0.),
-  pt_Ly_(0.),
-  pt_Lz_(0.),
+  voxel_phantom_(false),
+  point_gen_(nullptr),
   sensitivity_(false),
   events_per_point_(1),
   sensitivity_point_id_(0),
   sensitivity_index_(0),
   sensitivity_binning_(1 * mm),
+  sens_n_shards_(1),
+  sens_shard_index_(0),
+  sens_n_points_(0),
+  sens_first_point_(0),
+  sens_shard_points_(0),
+  sens_n_z_(0),
   sens_x_min_(-inner_radius_),
   sens_x_max_(inner_radius_),
   sens_y_min_(-inner_radius_),
@@ -110,8 +129,12 @@ FullRingInfinity::FullRingInfinity() :
                         "True if charge is detected");
   msg_->DeclareProperty("separators", separators_,
                         "True if separator panels are present");
+  msg_->DeclareProperty("replica_sensors", replica_sensors_,
+                        "True if the SiPM rings are built as replicas in phi");
   msg_->DeclareProperty("phantom", phantom_,
                         "True if Jaszczak phantom is used");
+  msg_->DeclareProperty("voxel_phantom", voxel_phantom_,
+                        "True if a voxelized phantom is used");
 
   G4GenericMessenger::Command& wire_pitch_cmd =
       msg_->DeclareProperty("wire_pitch", wire_pitch_, "Pitch of wires");
@@ -135,6 +158,10 @@ FullRingInfinity::FullRingInfinity() :
   msg_->DeclarePropertyWithUnit("specific_vertex", "mm",  specific_vertex_,
                                 "Generation vertex.");
 
+  msg_->DeclareMethod("photon_sink", &FullRingInfinity::AddPhotonSink,
+    "Name of a logical volume where optical photons are killed "
+    "after their first step inside.");
+
   // Read in the point distribution.
   msg_->DeclareMethod("pointFile", &FullRingInfinity::BuildPointfile,
     "Location of file containing distribution of event generation points.");
@@ -153,6 +180,18 @@ FullRingInfinity::FullRingInfinity() :
   msg_->DeclareProperty("events_per_point", events_per_point_,
                         "Number of events to be generated per point");
 
+  G4GenericMessenger::Command &n_shards_cmd =
+      msg_->DeclareProperty("sensitivity_n_shards", sens_n_shards_,
+                            "Number of jobs the sensitivity map is split into");
+  n_shards_cmd.SetParameterName("sensitivity_n_shards", false);
+  n_shards_cmd.SetRange("sensitivity_n_shards>0");
+
+  G4GenericMessenger::Command &shard_cmd =
+      msg_->DeclareProperty("sensitivity_shard_index", sens_shard_index_,
+                            "Job (from 0) whose part of the sensitivity map is run");
+  shard_cmd.SetParameterName("sensitivity_shard_index", false);
+  shard_cmd.SetRange("sensitivity_shard_index>=0");
+
   G4GenericMessenger::Command &sns_x_min_cmd =
       msg_->DeclareProperty("sens_x_min", sens_x_min_,
                             "Minimum x for sensitivity map");
@@ -190,15 +229,76 @@ FullRingInfinity::FullRingInfinity() :
   sns_z_max_cmd.SetParameterName("sens_z_max", false);
 
   sipm_ = new SiPMpetVUV();
+  vox_phantom_ = new VoxelPhantom();
+
+  // Their commands must exist before the configuration macros are executed
+  GeometryCache::Instance();
+  RegionSettings::Instance();
 }
 
 FullRingInfinity::~FullRingInfinity()
 {
-  delete[] pt_;
+  delete point_gen_;
 }
 
 void FullRingInfinity::Construct()
 {
+  InitProfiler::Scope profile("FullRingInfinity::Construct");
+
+  axial_length_ = sipm_pitch_ *  n_sipm_rows_;
+  G4cout << "Axial dimensions (mm) = " << axial_length_/mm << G4endl;
+
+  external_radius_ = inner_radius_ + lxe_depth_;
+  G4cout << "Radial dimensions (mm): "<< inner_radius_/mm << ", "
+	  << external_radius_/mm << G4endl;
+
+  sipm_->SetSensorDepth(1);
+  // With replicas, the sensor ID is the sum of the copy number of the SiPM,
+  // which encodes the row, and the one of its sector
+  if (replica_sensors_) {
+    sipm_->SetMotherDepth(2);
+    sipm_->SetNamingOrder(1);
+  }
+
+  // The phantoms keep the state needed to generate their vertices,
+  // so they are always constructed
+  GeometryCache& cache = GeometryCache::Instance();
+  G4bool use_cache = cache.IsEnabled() && !phantom_ && !voxel_phantom_;
+  G4String cache_key = "";
+  G4LogicalVolume* cached_lab = nullptr;
+  if (use_cache) {
+    std::vector<G4String> ignored;
+    for (G4String name : {"specific_vertex", "photon_sink", "pointFile",
+                          "sensitivity", "sensitivity_binning",
+                          "sensitivity_point_id", "events_per_point",
+                          "sensitivity_n_shards", "sensitivity_shard_index",
+                          "sens_x_min", "sens_x_max", "sens_y_min",
+                          "sens_y_max", "sens_z_min", "sens_z_max"})
+      ignored.push_back("/Geometry/FullRingInfinity/" + name);
+    cache_key = cache.Key("FullRingInfinity", ignored);
+    cached_lab = cache.Load(cache_key, "LAB");
+  }
+
+  if (cached_lab) {
+    RestoreGeometry(cached_lab);
+  }
+  else {
+    BuildGeometry();
+    if (use_cache) cache.Save(cache_key, lab_logic_);
+  }
+
+  DefineRegions();
+
+  if (sensitivity_)
+    CalculateSensitivityVertices(sensitivity_binning_);
+
+  PhotonSinkSD::SetPhotonSinks(photon_sinks_);
+}
+
+void FullRingInfinity::BuildGeometry()
+{
+  InitProfiler::Scope profile("FullRingInfinity::BuildGeometry");
+
   // LAB. This is just a volume of air surrounding the detector
   G4double lab_size = 10. * m;
   G4Box* lab_solid =
@@ -210,14 +310,6 @@ void FullRingInfinity::Construct()
   lab_logic_->SetVisAttributes(G4VisAttributes::GetInvisible());
   this->SetLogicalVolume(lab_logic_);
 
-  axial_length_ = sipm_pitch_ *  n_sipm_rows_;
-  G4cout << "Axial dimensions (mm) = " << axial_length_/mm << G4endl;
-
-  external_radius_ = inner_radius_ + lxe_depth_;
-  G4cout << "Radial dimensions (mm): "<< inner_radius_/mm << ", "
-	  << external_radius_/mm << G4endl;
-
-  sipm_->SetSensorDepth(1);
   sipm_->Construct();
   sipm_dim_ = sipm_->GetDimensions();
   G4cout << "SiPM size = " << sipm_dim_ << G4endl;
@@ -236,12 +328,60 @@ void FullRingInfinity::Construct()
   if (phantom_)
     BuildPhantom();
 
-  if (sensitivity_)
-    CalculateSensitivityVertices(sensitivity_binning_);
+  if (voxel_phantom_)
+    BuildVoxelPhantom();
+}
+
+void FullRingInfinity::RestoreGeometry(G4LogicalVolume* lab_logic)
+{
+  // GDML keeps the volumes and the optical surfaces, but not
+  // the sensitive detectors and the user limits
+  lab_logic_ = lab_logic;
+  this->SetLogicalVolume(lab_logic_);
+
+  PetIonizationSD* ionisd = new PetIonizationSD("/PETALO/ACTIVE");
+  G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
+  G4UserLimits* active_limits =
+    RegionSettings::Instance().StepLimits("ACTIVE", max_step_size_);
+
+  for (auto lv : *G4LogicalVolumeStore::GetInstance()) {
+    const G4String& name = lv->GetName();
+    if (name == "ACTIVE" || name.rfind("SIPM_RING", 0) == 0) {
+      if (name == "ACTIVE") active_logic_ = lv;
+      lv->SetSensitiveDetector(ionisd);
+      lv->SetUserLimits(active_limits);
+    }
+    else if (name == "PHOTODIODES") {
+      sipm_->AttachSensitiveDetector(lv);
+    }
+    else if (name == "WIRE") {
+      AttachWireSD(lv);
+    }
   }
+}
+
+void FullRingInfinity::DefineRegions()
+{
+  // Volumes are looked up by name, since the cached
+  // geometry does not construct the SiPM
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  RegionSettings& regions = RegionSettings::Instance();
+
+  regions.DefineRegion("SENSORS", {store->GetVolume("SIPMpet", false)});
+
+  std::vector<G4LogicalVolume*> phantoms;
+  if (phantom_) phantoms.push_back(jas_phantom_->GetLogicalVolume());
+  if (voxel_phantom_) phantoms.push_back(vox_phantom_->GetLogicalVolume());
+  if (!phantoms.empty()) regions.DefineRegion("PHANTOM", phantoms);
+
+  regions.DefineRegion("ACTIVE", {active_logic_});
+  regions.DefineRegion("PASSIVE", {store->GetVolume("VACUUM_VESSEL", false)});
+}
 
 void FullRingInfinity::BuildCryostat()
 {
+    InitProfiler::Scope profile("FullRingInfinity::BuildCryostat");
+
     const G4double extra_int_space = 2. * mm;
     const G4double elec_ext_space  = 2. * cm;
 
@@ -327,7 +467,8 @@ void FullRingInfinity::BuildCryostat()
     G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
     // Limit the step size in ACTIVE volume for better tracking precision
-    active_logic_->SetUserLimits(new G4UserLimits(max_step_size_));
+    active_logic_->SetUserLimits(
+      RegionSettings::Instance().StepLimits("ACTIVE", max_step_size_));
 
     // Reflectant panels
     G4Material* kapton =
@@ -364,12 +505,11 @@ void FullRingInfinity::BuildCryostat()
                       "KAPTON_LAT_NEG", LXe_logic_, false, 1, false);
 
     // OPTICAL SURFACE FOR REFLECTION
-    G4OpticalSurface* db_opsur = new G4OpticalSurface("BORDER");
-    db_opsur->SetType(dielectric_metal);
-    db_opsur->SetModel(unified);
-    db_opsur->SetFinish(ground);
-    db_opsur->SetSigmaAlpha(0.1);
-    db_opsur->SetMaterialPropertiesTable(petopticalprops::ReflectantSurface(wall_refl_));
+    OpticalRegistry& optreg = OpticalRegistry::Instance();
+    G4MaterialPropertiesTable* db_opsur_mpt =
+      optreg.Table("ReflectantSurface", petopticalprops::ReflectantSurface, wall_refl_);
+    G4OpticalSurface* db_opsur =
+      optreg.Surface("BORDER", unified, ground, dielectric_metal, db_opsur_mpt, 0.1);
     new G4LogicalSkinSurface("BORDER", kapton_lat_logic, db_opsur);
     new G4LogicalSkinSurface("BORDER", kapton_int_logic, db_opsur);
     new G4LogicalSkinSurface("BORDER", kapton_ext_logic, db_opsur);
@@ -388,6 +528,13 @@ void FullRingInfinity::BuildCryostat()
 
 void FullRingInfinity::BuildSensors()
 {
+  InitProfiler::Scope profile("FullRingInfinity::BuildSensors");
+
+  if (replica_sensors_) {
+    BuildReplicaSensors();
+    return;
+  }
+
   G4LogicalVolume* sipm_logic = sipm_->GetLogicalVolume();
   //G4double sipm_pitch = sipm_dim.x() + 1. * mm;
 
@@ -490,33 +637,119 @@ void FullRingInfinity::BuildSensors()
   }
 }
 
+void FullRingInfinity::BuildReplicaSensors()
+{
+  InitProfiler::Scope profile("FullRingInfinity::BuildReplicaSensors");
+
+  // Same sensors and IDs as the individual placements of BuildSensors()
+  if (charge_det_ && separators_) {
+    G4Exception("[FullRingInfinity]", "BuildReplicaSensors()", FatalException,
+                "Replicated sensors cannot be combined with separators.");
+  }
+
+  G4double sipm_half_x = sipm_dim_.x() / 2.;
+  G4double sipm_z      = sipm_dim_.z();
+
+  G4int n_sipm_int = 2 * pi * inner_radius_ / sipm_pitch_;
+  G4int first_id   = 1000;
+
+  if (instr_faces_ == 2) {
+    G4cout << "Number of sipms in inner face: " << n_sipm_int * n_sipm_rows_
+           << G4endl;
+
+    G4RotationMatrix rot;
+    rot.rotateX(-pi / 2.);
+    rot.rotateZ(-pi / 2.);
+
+    G4double r_max = std::hypot(inner_radius_ + sipm_z, sipm_half_x);
+    BuildSensorRing("SIPM_RING_INT", inner_radius_, r_max,
+                    inner_radius_ + sipm_z / 2., n_sipm_int, first_id, rot);
+    first_id += n_sipm_int * n_sipm_rows_;
+  }
+
+  n_sipm_ext_ = 2 * pi * external_radius_ / sipm_pitch_;
+  G4cout << "Number of sipms in external face: " << n_sipm_ext_ * n_sipm_rows_
+         << G4endl;
+
+  G4RotationMatrix rot;
+  rot.rotateX(pi / 2.);
+  rot.rotateZ(-pi / 2.);
+
+  G4double r_min = inner_radius_ + lxe_depth_;
+  G4double r_max = std::hypot(r_min + sipm_z, sipm_half_x);
+  if (r_max > r_min + sipm_z + offset_) {
+    G4Exception("[FullRingInfinity]", "BuildReplicaSensors()", FatalException,
+                "The external ring of SiPMs does not fit in ACTIVE.");
+  }
+  BuildSensorRing("SIPM_RING_EXT", r_min, r_max, r_min + sipm_z / 2.,
+                  n_sipm_ext_, first_id, rot);
+}
+
+void FullRingInfinity::BuildSensorRing(const G4String& name, G4double r_min,
+                                       G4double r_max, G4double sipm_radius,
+                                       G4int n_phi, G4int first_id,
+                                       const G4RotationMatrix& rot)
+{
+  InitProfiler::Scope profile("FullRingInfinity::BuildSensorRing");
+
+  G4double step = 2. * pi / n_phi;
+  if (2. * std::atan(sipm_dim_.x() / 2. / r_min) > step) {
+    G4Exception("[FullRingInfinity]", "BuildSensorRing()", FatalException,
+                ("The SiPMs do not fit in the sectors of " + name).c_str());
+  }
+
+  G4Tubs* ring_solid =
+    new G4Tubs(name, r_min, r_max, axial_length_/2., 0, twopi);
+  G4LogicalVolume* ring_logic = new G4LogicalVolume(ring_solid, LXe_, name);
+  new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), ring_logic,
+                    name, active_logic_, false, 0, false);
+
+  // Sector k is centred at the angle where BuildSensors() places
+  // the SiPM k of each row
+  G4String sector_name = name + "_SECTOR";
+  G4Tubs* sector_solid =
+    new G4Tubs(sector_name, r_min, r_max, axial_length_/2., -step/2., step);
+  G4LogicalVolume* sector_logic =
+    new G4LogicalVolume(sector_solid, LXe_, sector_name);
+  new G4PVReplica(sector_name, sector_logic, ring_logic,
+                  kPhi, n_phi, step, pi/2. - step/2.);
+
+  // The rings are part of the active LXe
+  for (auto logic : {ring_logic, sector_logic}) {
+    logic->SetSensitiveDetector(active_logic_->GetSensitiveDetector());
+    logic->SetUserLimits(active_logic_->GetUserLimits());
+    logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+  }
+
+  G4LogicalVolume* sipm_logic = sipm_->GetLogicalVolume();
+  for (G4int j = 0; j < n_sipm_rows_; j++) {
+    G4double z_pos = -axial_length_ / 2. + (j + 1. / 2.) * sipm_pitch_;
+    G4int copy_no  = first_id + j * n_phi;
+    new G4PVPlacement(G4Transform3D(rot, G4ThreeVector(sipm_radius, 0., z_pos)),
+                      sipm_logic, "SIPM", sector_logic, false, copy_no, false);
+  }
+}
+
 void FullRingInfinity::BuildWires()
 {
+  InitProfiler::Scope profile("FullRingInfinity::BuildWires");
+
   // Add simple detector for charge
   G4Box* chdet_solid = new G4Box("WIRE", wire_pitch_/2.,
                                  axial_length_/2., chdet_thickn_/2);
   G4LogicalVolume* chdet_logic =
     new G4LogicalVolume(chdet_solid, LXe_, "WIRE");
 
-  G4String sdname = "/WIRE/ChargeDet";
-  G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
-  if (!sdmgr->FindSensitiveDetector(sdname, false))
-    {
-      ChargeSD* chargesd = new ChargeSD(sdname);
-      chargesd->SetTimeBinning(wire_time_bin_);
-      G4SDManager::GetSDMpointer()->AddNewDetector(chargesd);
-      chdet_logic->SetSensitiveDetector(chargesd);
-    }
+  G4double chdet_radius = WireRadius();
+  G4int n_wires = 2. * pi * chdet_radius / wire_pitch_;
+  G4cout << "Number of wires: " << n_wires << G4endl;
+
+  AttachWireSD(chdet_logic);
 
   G4VisAttributes wire_col = nexus::Yellow();
   wire_col.SetForceSolid(true);
   chdet_logic->SetVisAttributes(wire_col);
 
-  G4double chdet_radius =
-    inner_radius_ + lxe_depth_ - chdet_thickn_ / 2. - chdet_offset_;
-  G4int n_wires = 2. * pi * chdet_radius / wire_pitch_;
-  G4cout << "Number of wires: " << n_wires << G4endl;
-
   G4ThreeVector chdet_position(0., chdet_radius, 0.);
   G4int chdet_copy_no = 0;
   G4String chdet_vol_name = "WIRE_" + std::to_string(chdet_copy_no);
@@ -539,8 +772,32 @@ void FullRingInfinity::BuildWires()
   }
 }
 
+G4double FullRingInfinity::WireRadius() const
+{
+  return inner_radius_ + lxe_depth_ - chdet_thickn_ / 2. - chdet_offset_;
+}
+
+void FullRingInfinity::AttachWireSD(G4LogicalVolume* wire_logic)
+{
+  G4double chdet_radius = WireRadius();
+  G4int n_wires = 2. * pi * chdet_radius / wire_pitch_;
+
+  G4String sdname = "/WIRE/ChargeDet";
+  G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
+  if (!sdmgr->FindSensitiveDetector(sdname, false))
+    {
+      ChargeSD* chargesd = new ChargeSD(sdname);
+      chargesd->SetTimeBinning(wire_time_bin_);
+      chargesd->SetWireRing(chdet_radius, n_wires, axial_length_/2.);
+      G4SDManager::GetSDMpointer()->AddNewDetector(chargesd);
+      wire_logic->SetSensitiveDetector(chargesd);
+    }
+}
+
 void FullRingInfinity::BuildSeparators()
 {
+  InitProfiler::Scope profile("FullRingInfinity::BuildSeparators");
+
   // Separate LXe volume in smaller areas with teflon panels
   G4Material* teflon =
     G4NistManager::Instance()->FindOrBuildMaterial("G4_TEFLON");
@@ -606,6 +863,8 @@ void FullRingInfinity::BuildSeparators()
 
 void FullRingInfinity::BuildPhantom()
 {
+  InitProfiler::Scope profile("FullRingInfinity::BuildPhantom");
+
   jas_phantom_ = new JaszczakPhantom();
   jas_phantom_->Construct();
   G4LogicalVolume* phantom_logic = jas_phantom_->GetLogicalVolume();
@@ -623,6 +882,15 @@ void FullRingInfinity::BuildPhantom()
   //     new SpherePointSampler(0., phantom_diam_ / 2, phantom_origin);
 }
 
+void FullRingInfinity::BuildVoxelPhantom()
+{
+  InitProfiler::Scope profile("FullRingInfinity::BuildVoxelPhantom");
+
+  vox_phantom_->Construct();
+  new G4PVPlacement(0, G4ThreeVector(0, 0, 0), vox_phantom_->GetLogicalVolume(),
+                    "VOXEL_PHANTOM", lab_logic_, false, 0, true);
+}
+
 G4ThreeVector FullRingInfinity::GenerateVertex(const G4String &region) const
 {
 
@@ -640,31 +908,42 @@ G4ThreeVector FullRingInfinity::GenerateVertex(const G4String &region) const
   {
     vertex = jas_phantom_->GenerateVertex("JPHANTOM");
   }
+  else if (region == "VOXEL_PHANTOM")
+  {
+    vertex = vox_phantom_->GenerateVertex("VOXEL_PHANTOM");
+  }
   else if (region == "CUSTOM")
   {
-    vertex = RandomPointVertex();
+    if (!point_gen_)
+    {
+      G4Exception("[FullRingInfinity]", "GenerateVertex()", FatalException,
+                  "No point file given for the CUSTOM region.");
+    }
+    vertex = point_gen_->GenerateVertex();
   }
   else if (region == "SENSITIVITY")
   {
-    unsigned int i = sensitivity_point_id_ + sensitivity_index_;
-
-    if (i == (sensitivity_vertices_.size() * events_per_point_ - 1))
+    // The index of the event in the run is also right when the run is
+    // split in several processes or resumed from a checkpoint
+    PetaloPersistencyManager* pm = dynamic_cast<PetaloPersistencyManager*>
+      (G4VPersistencyManager::GetPersistencyManager());
+    G4long i = sensitivity_point_id_ +
+      (pm ? pm->CurrentEventIndex() : sensitivity_index_);
+
+    if (i == sens_shard_points_ * events_per_point_ - 1)
     {
       G4Exception("[FullRingInfinity]", "GenerateVertex()",
                   RunMustBeAborted, "Reached last event in sensitivity map.");
     }
 
-    try
-    {
-      auto pos = i % sensitivity_vertices_.size();
-      vertex = sensitivity_vertices_.at(pos);
-      sensitivity_index_++;
-    }
-    catch (const std::out_of_range &oor)
+    if (i < 0 || sens_shard_points_ == 0)
     {
       G4Exception("[FullRingInfinity]", "GenerateVertex()",
                   FatalErrorInArgument, "Sensitivity point out of range.");
     }
+
+    vertex = SensitivityVertex(sens_first_point_ + i % sens_shard_points_);
+    sensitivity_index_++;
   }
   else
   {
@@ -674,126 +953,95 @@ G4ThreeVector FullRingInfinity::GenerateVertex(const G4String &region) const
   return vertex;
 }
 
-G4int FullRingInfinity::binarySearchPt(G4int low,
-                                       G4int high, G4double rnd) const
-{
-
-  // Error
-  if (high < 0 || low >= pt_Nx_ * pt_Ny_ * pt_Nz_)
-    return -1;
-
-  // Return the element before the first element greater than rnd.
-  if (pt_[low] > rnd)
-    return low - 1;
-
-  G4int mid = (low + high) / 2;
-  if (pt_[mid] <= rnd)
-    return binarySearchPt(mid + 1, high, rnd);
-  return binarySearchPt(low, mid - 1, rnd);
-}
-
-// Generates a vertex corresponding to a random point from the custom volume.
-G4ThreeVector FullRingInfinity::RandomPointVertex() const
-{
-  // Select the index in the cumulative distribution.
-  G4double rnd = G4UniformRand();
-  G4int ipt = binarySearchPt(0, pt_Nx_ * pt_Ny_ * pt_Nz_ - 1, rnd);
-
-  if (ipt < 0)
-  {
-    std::cerr << "ERROR: random point vertex selection failed." << std::endl;
-    return G4ThreeVector(0, 0, 0);
-  }
-  //G4int jpt = 0;
-  //while(pt_[jpt] < rnd) jpt++;
-  //jpt -= 1;
-  //if(ipt != jpt) std::cout << "WARNING: algorithms don't match i = " << ipt
-  // << ", j = " << jpt << "***" << std::endl;
-
-  // Compute the vertex.
-  G4int nx = ipt / (pt_Ny_ * pt_Nz_);
-  G4int ny = (ipt / pt_Nz_) % pt_Ny_;
-  G4int nz = ipt % pt_Nz_;
-  G4double x = pt_Lx_ * (((G4double)nx) / pt_Nx_ - 0.5);
-  G4double y = pt_Ly_ * (((G4double)ny) / pt_Ny_ - 0.5);
-  G4double z = pt_Lz_ * (((G4double)nz) / pt_Nz_ - 0.5);
-
-  G4double xrnd = G4UniformRand() - 0.5;
-  G4double yrnd = G4UniformRand() - 0.5;
-  G4double zrnd = G4UniformRand() - 0.5;
-
-  //std::cout << "Generated at point (" << x << ", " << y << ", " << z << "),
-  // index " << ipt << std::endl;
-  return G4ThreeVector(x + xrnd, y + yrnd, z + zrnd);
-}
-
 void FullRingInfinity::BuildPointfile(G4String pointFile)
 {
-  int Nx, Ny, Nz;
-  float Lx, Ly, Lz;
-
-  // Open the file containing the point distribution.
-  std::ifstream is;
-  is.open(pointFile, std::ifstream::binary);
-
-  // Read the header.
-  is.read(reinterpret_cast<char *>(&Nx), sizeof(int));
-  is.read(reinterpret_cast<char *>(&Ny), sizeof(int));
-  is.read(reinterpret_cast<char *>(&Nz), sizeof(int));
-  is.read(reinterpret_cast<char *>(&Lx), sizeof(float));
-  is.read(reinterpret_cast<char *>(&Ly), sizeof(float));
-  is.read(reinterpret_cast<char *>(&Lz), sizeof(float));
-  pt_Nx_ = Nx;
-  pt_Ny_ = Ny;
-  pt_Nz_ = Nz;
-  pt_Lx_ = Lx;
-  pt_Ly_ = Ly;
-  pt_Lz_ = Lz;
-
-  // Read the distribution.
-  int i = 0;
-  float f;
-  int length = pt_Nx_ * pt_Ny_ * pt_Nz_;
-  pt_ = new G4float[length];
-  while (is.read(reinterpret_cast<char *>(&f), sizeof(float)))
-  {
-    pt_[i] = f;
-    i++;
-  }
-
-  is.close();
-
-  std::cout << "Read distribution of (" << pt_Nx_ << ", " << pt_Ny_ << ", "
-            << pt_Nz_ << "); Len (" << pt_Lx_ << ", " << pt_Ly_ << ", "
-            << pt_Lz_ << "); with total elements = " << length
-            << ", and first two = " << pt_[0] << " , " << pt_[1] << std::endl;
+  delete point_gen_;
+  point_gen_ = new VoxelPointSampler(pointFile);
 }
 
 void FullRingInfinity::CalculateSensitivityVertices(G4double binning)
 {
-  sensitivity_vertices_.clear();
+  // Only the range of valid y indices of each x row is stored:
+  // the points inside the ring are contiguous in y for a fixed x
+  sens_first_y_.clear();
+  sens_cumul_points_.clear();
 
   G4int i_max = floor((sens_x_max_ - sens_x_min_) / binning);
   G4int j_max = floor((sens_y_max_ - sens_y_min_) / binning);
-  G4int k_max = floor((sens_z_max_ - sens_z_min_) / binning);
+  sens_n_z_   = std::max(G4int(floor((sens_z_max_ - sens_z_min_) / binning)), 0);
 
+  sens_n_points_ = 0;
   for (G4int i = 0; i < i_max; i++)
   {
     G4double x = sens_x_min_ + i * binning;
+    G4int first_y = 0;
+    G4int n_y     = 0;
     for (G4int j = 0; j < j_max; j++)
     {
       G4double y = sens_y_min_ + j * binning;
-      for (G4int k = 0; k < k_max; k++)
+      if ((x * x + y * y) < inner_radius_ * inner_radius_)
       {
-        G4double z = sens_z_min_ + k * binning;
-        if ((x * x + y * y) < inner_radius_ * inner_radius_)
-        {
-          G4ThreeVector point(x, y, z);
-          sensitivity_vertices_.push_back(point);
-        }
+        if (n_y == 0) first_y = j;
+        n_y++;
       }
     }
+    sens_n_points_ += G4long(n_y) * sens_n_z_;
+    sens_first_y_.push_back(first_y);
+    sens_cumul_points_.push_back(sens_n_points_);
+  }
+
+  if (sens_shard_index_ >= sens_n_shards_)
+  {
+    G4Exception("[FullRingInfinity]", "CalculateSensitivityVertices()",
+                FatalErrorInArgument,
+                "The shard index must be smaller than the number of shards.");
+  }
+
+  // Each shard runs a contiguous range of points
+  sens_first_point_  = sens_n_points_ * sens_shard_index_ / sens_n_shards_;
+  sens_shard_points_ =
+    sens_n_points_ * (sens_shard_index_ + 1) / sens_n_shards_ - sens_first_point_;
+
+  G4cout << "Number of points in sensitivity map = " << sens_n_points_;
+  if (sens_n_shards_ > 1)
+    G4cout << ", running points " << sens_first_point_ << " to "
+           << sens_first_point_ + sens_shard_points_ - 1 << " (shard "
+           << sens_shard_index_ << " of " << sens_n_shards_ << ")";
+  G4cout << G4endl;
+
+  PetaloPersistencyManager* pm = dynamic_cast<PetaloPersistencyManager*>
+    (G4VPersistencyManager::GetPersistencyManager());
+  if (pm)
+  {
+    pm->SetRunInfo("sensitivity_points", std::to_string(sens_n_points_));
+    pm->SetRunInfo("sensitivity_events_per_point",
+                   std::to_string(events_per_point_));
+    pm->SetRunInfo("sensitivity_first_point", std::to_string(sens_first_point_));
+    pm->SetRunInfo("sensitivity_shard_points", std::to_string(sens_shard_points_));
   }
-  G4cout << "Number of points in sensitivity map = "
-         << sensitivity_vertices_.size() << G4endl;
+}
+
+G4ThreeVector FullRingInfinity::SensitivityVertex(G4long point) const
+{
+  auto row = std::upper_bound(sens_cumul_points_.begin(),
+                              sens_cumul_points_.end(), point);
+  if (point < 0 || row == sens_cumul_points_.end())
+  {
+    G4Exception("[FullRingInfinity]", "SensitivityVertex()",
+                FatalErrorInArgument, "Sensitivity point out of range.");
+  }
+
+  G4int i = row - sens_cumul_points_.begin();
+  G4long in_row = point - (i > 0 ? sens_cumul_points_[i-1] : 0);
+  G4int j = sens_first_y_[i] + in_row / sens_n_z_;
+  G4int k = in_row % sens_n_z_;
+
+  return G4ThreeVector(sens_x_min_ + i * sensitivity_binning_,
+                       sens_y_min_ + j * sensitivity_binning_,
+                       sens_z_min_ + k * sensitivity_binning_);
+}
+
+void FullRingInfinity::AddPhotonSink(G4String volume)
+{
+  photon_sinks_.push_back(volume);
 }
@@ -11,6 +11,8 @@
 #define FULL_RING_INF_H
 
 #include "nexus/GeometryBase.h"
+
+#include <G4RotationMatrix.hh>
 #include <vector>
 
 class G4GenericMessenger;
@@ -19,6 +21,8 @@ class G4Material;
 
 class SiPMpetVUV;
 class JaszczakPhantom;
+class VoxelPhantom;
+class VoxelPointSampler;
 
 namespace nexus
 {
@@ -41,16 +45,31 @@ public:
 
 private:
   void Construct();
+  void BuildGeometry();
+  /// Use a geometry read from the cache, attaching its sensitive detectors
+  void RestoreGeometry(G4LogicalVolume* lab_logic);
+  /// Create the regions with their own production cuts and step limits
+  void DefineRegions();
   void BuildCryostat();
   void BuildQuadSensors();
   void BuildSensors();
+  void BuildReplicaSensors();
+  /// Ring of SiPMs built as a replica of sectors in phi,
+  /// each with one SiPM per row
+  void BuildSensorRing(const G4String& name, G4double r_min, G4double r_max,
+                       G4double sipm_radius, G4int n_phi, G4int first_id,
+                       const G4RotationMatrix& rot);
   void BuildWires();
+  G4double WireRadius() const;
+  void AttachWireSD(G4LogicalVolume* wire_logic);
   void BuildSeparators();
   void BuildPhantom();
+  void BuildVoxelPhantom();
   void BuildPointfile(G4String pointFile);
-  G4int binarySearchPt(G4int low, G4int high, G4double rnd) const;
-  G4ThreeVector RandomPointVertex() const;
   void CalculateSensitivityVertices(G4double binning);
+  /// Position of a given point of the sensitivity map
+  G4ThreeVector SensitivityVertex(G4long point) const;
+  void AddPhotonSink(G4String volume);
 
   SiPMpetVUV *sipm_;
 
@@ -67,6 +86,7 @@ private:
   G4int instr_faces_; ///< number of instrumented faces
   G4bool charge_det_;
   G4bool separators_;
+  G4bool replica_sensors_; ///< build the SiPM rings as replicas in phi
   G4double wire_pitch_;
   G4double wire_time_bin_;
   G4double chdet_thickn_;
@@ -97,24 +117,34 @@ private:
   G4ThreeVector specific_vertex_;
 
   G4bool phantom_;
+  G4bool voxel_phantom_;
 
-  // Variables for the point generator.
-  G4int pt_Nx_, pt_Ny_, pt_Nz_;
-  G4float pt_Lx_, pt_Ly_, pt_Lz_;
-  G4float *pt_;
+  VoxelPointSampler* point_gen_; ///< Generator of the CUSTOM region
 
   G4bool sensitivity_;
   G4int events_per_point_;
   G4int sensitivity_point_id_;
   mutable G4int sensitivity_index_;
-  mutable std::vector<G4ThreeVector> sensitivity_vertices_;
   G4double sensitivity_binning_;
+  G4int sens_n_shards_;    ///< number of jobs the map is split into
+  G4int sens_shard_index_; ///< job to which this run belongs
+  G4long sens_n_points_;   ///< points in the whole map
+  G4long sens_first_point_, sens_shard_points_; ///< points of this job
+  G4int sens_n_z_;         ///< points along z for each (x, y)
+  /// First y index and number of points up to the end of each x row,
+  /// from which the points are computed when needed
+  std::vector<G4int> sens_first_y_;
+  std::vector<G4long> sens_cumul_points_;
   G4double sens_x_min_, sens_x_max_;
   G4double sens_y_min_, sens_y_max_;
   G4double sens_z_min_, sens_z_max_;
 
   G4Material* LXe_;
   JaszczakPhantom* jas_phantom_;
+  VoxelPhantom* vox_phantom_;
+
+  /// Logical volumes where optical photons are killed
+  std::vector<G4String> photon_sinks_;
 };
 
 #endif
@@ -11,7 +11,15 @@
 #include "SiPMpetFBK.h"
 #include "Tile.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "PetIonizationSD.h"
+#include "PhotonSinkSD.h"
+#include "VoxelPhantom.h"
+#include "RegionSettings.h"
+#include "GeometryCache.h"
+#include "InitProfiler.h"
+#include "OverlapCheck.h"
+#include "VoxelPointSampler.h"
 
 #include "nexus/CylinderPointSamplerLegacy.h"
 #include "nexus/Visibilities.h"
@@ -24,7 +32,9 @@
 #include <G4Tubs.hh>
 #include <G4Material.hh>
 #include <G4LogicalVolume.hh>
+#include <G4LogicalVolumeStore.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVReplica.hh>
 #include <G4NistManager.hh>
 #include <G4VisAttributes.hh>
 #include <G4LogicalVolume.hh>
@@ -49,6 +59,8 @@ FullRingTiles::FullRingTiles() : GeometryBase(),
                                  inner_radius_(165 * cm),
                                  cryo_width_(12. * cm),
                                  cryo_thickn_(1. * mm),
+                                 replica_blocks_(false),
+                                 voxel_phantom_(false),
                                  max_step_size_(1. * mm)
 {
   // Messenger
@@ -71,8 +83,22 @@ FullRingTiles::FullRingTiles() : GeometryBase(),
   msg_->DeclareProperty("tile_rows", n_tile_rows_, "Number of tile rows");
   msg_->DeclareProperty("instrumented_faces", instr_faces_,
                         "Number of instrumented faces");
+  msg_->DeclareProperty("replica_blocks", replica_blocks_,
+                        "True if the blocks of two tiles are built as replicas in phi");
+  msg_->DeclareProperty("voxel_phantom", voxel_phantom_,
+                        "True if a voxelized phantom is used");
+  msg_->DeclareMethod("photon_sink", &FullRingTiles::AddPhotonSink,
+                      "Name of a logical volume where optical photons are killed "
+                      "after their first step inside.");
+  msg_->DeclareMethod("pointFile", &FullRingTiles::BuildPointfile,
+                      "Location of file containing distribution of event generation points.");
 
   tile_ = new Tile();
+  vox_phantom_ = new VoxelPhantom();
+
+  // Their commands must exist before the configuration macros are executed
+  GeometryCache::Instance();
+  RegionSettings::Instance();
 
   phantom_diam_ = 12. * cm;
   phantom_length_ = 10. * cm;
@@ -80,14 +106,62 @@ FullRingTiles::FullRingTiles() : GeometryBase(),
   cylindric_gen_ =
     new CylinderPointSamplerLegacy(0., phantom_length_, phantom_diam_ / 2., 0.,
                                    G4ThreeVector(0., 0., 0.));
+
+  point_gen_ = nullptr;
 }
 
 FullRingTiles::~FullRingTiles()
 {
+  delete point_gen_;
 }
 
 void FullRingTiles::Construct()
 {
+  InitProfiler::Scope profile("FullRingTiles::Construct");
+
+  // With replicas, the ID of a tile is the sum of its copy number in
+  // the block, which encodes the row, and twice the one of its block
+  if (replica_blocks_)
+    tile_->SetReplicaDepth(1, 2);
+  tile_dim_ = tile_->GetDimensions();
+
+  lat_dimension_cell_ = tile_dim_.y() * n_tile_rows_;
+  G4cout << "Lateral dimensions (mm) = " << lat_dimension_cell_ / mm << G4endl;
+
+  external_radius_ = inner_radius_ + depth_;
+  G4cout << "Radial dimensions (mm): " << inner_radius_ / mm
+         << ", " << external_radius_ / mm << G4endl;
+
+  // The voxel phantom keeps the state needed to generate its vertices,
+  // so it is always constructed
+  GeometryCache& cache = GeometryCache::Instance();
+  G4bool use_cache = cache.IsEnabled() && !voxel_phantom_;
+  G4String cache_key = "";
+  G4LogicalVolume* cached_lab = nullptr;
+  if (use_cache) {
+    cache_key = cache.Key("FullRingTiles",
+      {"/Geometry/FullRingTiles/photon_sink",
+       "/Geometry/FullRingTiles/pointFile"});
+    cached_lab = cache.Load(cache_key, "LAB");
+  }
+
+  if (cached_lab) {
+    RestoreGeometry(cached_lab);
+  }
+  else {
+    BuildGeometry();
+    if (use_cache) cache.Save(cache_key, lab_logic_);
+  }
+
+  DefineRegions();
+
+  PhotonSinkSD::SetPhotonSinks(photon_sinks_);
+}
+
+void FullRingTiles::BuildGeometry()
+{
+  InitProfiler::Scope profile("FullRingTiles::BuildGeometry");
+
   // LAB. This is just a volume of air surrounding the detector
   G4double lab_size = 1. * m;
   G4Box* lab_solid =
@@ -100,20 +174,60 @@ void FullRingTiles::Construct()
 
   tile_->Construct();
   tile_logic_ = tile_->GetLogicalVolume();
-  tile_dim_ = tile_->GetDimensions();
-
-  lat_dimension_cell_ = tile_dim_.y() * n_tile_rows_;
-  G4cout << "Lateral dimensions (mm) = " << lat_dimension_cell_ / mm << G4endl;
 
-  external_radius_ = inner_radius_ + depth_;
-  G4cout << "Radial dimensions (mm): " << inner_radius_ / mm
-         << ", " << external_radius_ / mm << G4endl;
   BuildCryostat();
   BuildSensors();
+
+  if (voxel_phantom_)
+    BuildVoxelPhantom();
+}
+
+void FullRingTiles::RestoreGeometry(G4LogicalVolume* lab_logic)
+{
+  // GDML keeps the volumes and the optical surfaces, but not
+  // the sensitive detectors and the user limits
+  lab_logic_ = lab_logic;
+  this->SetLogicalVolume(lab_logic_);
+
+  PetIonizationSD* ionisd = new PetIonizationSD("/PETALO/ACTIVE");
+  G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
+  G4UserLimits* active_limits =
+    RegionSettings::Instance().StepLimits("ACTIVE", max_step_size_);
+
+  for (auto lv : *G4LogicalVolumeStore::GetInstance()) {
+    const G4String& name = lv->GetName();
+    if (name == "ACTIVE" || name == "TILE_RING" || name == "TILE_BLOCK") {
+      if (name == "ACTIVE") active_logic_ = lv;
+      lv->SetSensitiveDetector(ionisd);
+      lv->SetUserLimits(active_limits);
+    }
+    else if (name == "TILE") {
+      tile_logic_ = lv;
+    }
+    else if (name == "PHOTODIODES") {
+      tile_->AttachSensitiveDetector(lv);
+    }
+  }
+}
+
+void FullRingTiles::DefineRegions()
+{
+  RegionSettings& regions = RegionSettings::Instance();
+
+  regions.DefineRegion("SENSORS", {tile_logic_});
+  if (voxel_phantom_)
+    regions.DefineRegion("PHANTOM", {vox_phantom_->GetLogicalVolume()});
+  regions.DefineRegion("ACTIVE", {active_logic_});
+  regions.DefineRegion("PASSIVE",
+    {G4LogicalVolumeStore::GetInstance()->GetVolume("CRYOSTAT", false)});
 }
 
 void FullRingTiles::BuildCryostat()
 {
+  InitProfiler::Scope profile("FullRingTiles::BuildCryostat");
+
+  G4bool check_overlaps = OverlapCheck::Instance().IsEnabled();
+
   const G4double space_for_elec = 2. * cm;
   const G4double int_radius_cryo =
     inner_radius_ - cryo_thickn_ - space_for_elec;
@@ -127,7 +241,7 @@ void FullRingTiles::BuildCryostat()
   G4LogicalVolume* cryostat_logic =
       new G4LogicalVolume(cryostat_solid, steel, "CRYOSTAT");
   new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), cryostat_logic,
-                    "CRYOSTAT", lab_logic_, false, 0, true);
+                    "CRYOSTAT", lab_logic_, false, 0, check_overlaps);
 
   G4double ext_offset = 4. * mm;
   G4Tubs* LXe_solid =
@@ -139,7 +253,7 @@ void FullRingTiles::BuildCryostat()
   LXe_logic_ =
       new G4LogicalVolume(LXe_solid, LXe, "LXE");
   new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), LXe_logic_,
-                    "LXE", cryostat_logic, false, 0, true);
+                    "LXE", cryostat_logic, false, 0, check_overlaps);
 
   G4Tubs* active_solid =
       new G4Tubs("ACTIVE", inner_radius_, external_radius_ + ext_offset,
@@ -147,7 +261,7 @@ void FullRingTiles::BuildCryostat()
   active_logic_ =
       new G4LogicalVolume(active_solid, LXe, "ACTIVE");
   new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), active_logic_,
-                    "ACTIVE", LXe_logic_, false, 0, true);
+                    "ACTIVE", LXe_logic_, false, 0, check_overlaps);
 
   // Set the ACTIVE volume as an ionization sensitive det
   PetIonizationSD* ionisd = new PetIonizationSD("/PETALO/ACTIVE");
@@ -155,7 +269,8 @@ void FullRingTiles::BuildCryostat()
   G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
   // Limit the step size in ACTIVE volume for better tracking precision
-  active_logic_->SetUserLimits(new G4UserLimits(max_step_size_));
+  active_logic_->SetUserLimits(
+    RegionSettings::Instance().StepLimits("ACTIVE", max_step_size_));
 
   G4Material* kapton =
       G4NistManager::Instance()->FindOrBuildMaterial("G4_KAPTON");
@@ -166,7 +281,7 @@ void FullRingTiles::BuildCryostat()
   G4LogicalVolume* kapton_int_logic =
       new G4LogicalVolume(kapton_int_solid, kapton, "KAPTON");
   new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), kapton_int_logic,
-                    "KAPTON", LXe_logic_, false, 0, true);
+                    "KAPTON", LXe_logic_, false, 0, check_overlaps);
 
   G4Tubs* kapton_ext_solid =
       new G4Tubs("KAPTON", external_radius_ + ext_offset,
@@ -175,7 +290,7 @@ void FullRingTiles::BuildCryostat()
   G4LogicalVolume* kapton_ext_logic =
       new G4LogicalVolume(kapton_ext_solid, kapton, "KAPTON");
   new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), kapton_ext_logic,
-                    "KAPTON", LXe_logic_, false, 0, true);
+                    "KAPTON", LXe_logic_, false, 0, check_overlaps);
 
   G4Tubs* kapton_lat_solid =
       new G4Tubs("KAPTON", inner_radius_ - kapton_thickn_,
@@ -185,17 +300,16 @@ void FullRingTiles::BuildCryostat()
       new G4LogicalVolume(kapton_lat_solid, kapton, "KAPTON");
   G4double z_pos = lat_dimension_cell_ / 2. + kapton_thickn_ / 2.;
   new G4PVPlacement(0, G4ThreeVector(0., 0., z_pos), kapton_lat_logic,
-                    "KAPTON", LXe_logic_, false, 0, true);
+                    "KAPTON", LXe_logic_, false, 0, check_overlaps);
   new G4PVPlacement(0, G4ThreeVector(0., 0., -z_pos), kapton_lat_logic,
-                    "KAPTON", LXe_logic_, false, 1, true);
+                    "KAPTON", LXe_logic_, false, 1, check_overlaps);
 
   // OPTICAL SURFACE FOR REFLECTION
-  G4OpticalSurface* db_opsur = new G4OpticalSurface("BORDER");
-  db_opsur->SetType(dielectric_metal);
-  db_opsur->SetModel(unified);
-  db_opsur->SetFinish(ground);
-  db_opsur->SetSigmaAlpha(0.1);
-  db_opsur->SetMaterialPropertiesTable(petopticalprops::ReflectantSurface(0.));
+  OpticalRegistry& optreg = OpticalRegistry::Instance();
+  G4MaterialPropertiesTable* db_opsur_mpt =
+    optreg.Table("ReflectantSurface", petopticalprops::ReflectantSurface, 0.);
+  G4OpticalSurface* db_opsur =
+    optreg.Surface("BORDER", unified, ground, dielectric_metal, db_opsur_mpt, 0.1);
   new G4LogicalSkinSurface("BORDER", kapton_lat_logic, db_opsur);
   new G4LogicalSkinSurface("BORDER", kapton_int_logic, db_opsur);
   new G4LogicalSkinSurface("BORDER", kapton_ext_logic, db_opsur);
@@ -214,6 +328,13 @@ void FullRingTiles::BuildCryostat()
 
 void FullRingTiles::BuildSensors()
 {
+  InitProfiler::Scope profile("FullRingTiles::BuildSensors");
+
+  if (replica_blocks_) {
+    BuildReplicaSensors();
+    return;
+  }
+
   G4double batch_sep = 1. * mm;
   G4double tile_sep = 0.050 * mm;
   G4double block_size = 2 * tile_dim_.x() + tile_sep + batch_sep;
@@ -274,14 +395,101 @@ void FullRingTiles::BuildSensors()
   }
 }
 
+void FullRingTiles::BuildReplicaSensors()
+{
+  InitProfiler::Scope profile("FullRingTiles::BuildReplicaSensors");
+
+  G4bool check_overlaps = OverlapCheck::Instance().IsEnabled();
+
+  G4double batch_sep = 1. * mm;
+  G4double tile_sep = 0.050 * mm;
+  G4double block_size = 2 * tile_dim_.x() + tile_sep + batch_sep;
+  G4int n_batches_per_row = 2 * pi * external_radius_ / block_size;
+  G4cout << "Number of SiPMs: " << n_batches_per_row * 2 * n_tile_rows_ * 32
+         << G4endl;
+  G4double step = 2. * pi / n_batches_per_row;
+
+  // The external radius distance must be at the level of the SiPM surfaces
+  G4double radius = external_radius_ + tile_dim_.z() / 2. - 1.2 * mm;
+
+  // The block of two tiles, with the separation between them,
+  // and its distance to the corners of the tiles
+  G4double block_half_x = tile_sep / 2. + tile_dim_.x();
+  G4double r_min = radius - tile_dim_.z() / 2.;
+  G4double r_max = std::hypot(radius + tile_dim_.z() / 2., block_half_x);
+
+  G4double active_r_max =
+    static_cast<G4Tubs*>(active_logic_->GetSolid())->GetOuterRadius();
+  if (r_max > active_r_max || 2. * std::atan(block_half_x / r_min) > step) {
+    G4Exception("[FullRingTiles]", "BuildReplicaSensors()", FatalException,
+                "The blocks of tiles do not fit in their sectors.");
+  }
+
+  G4Tubs* ring_solid =
+    new G4Tubs("TILE_RING", r_min, r_max, lat_dimension_cell_ / 2., 0, twopi);
+  G4LogicalVolume* ring_logic =
+    new G4LogicalVolume(ring_solid, active_logic_->GetMaterial(), "TILE_RING");
+  new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), ring_logic,
+                    "TILE_RING", active_logic_, false, 0, check_overlaps);
+
+  // Block k is centred at the angle where BuildSensors() places the
+  // tiles 2k+1 and 2k+2 of each row, and its local x axis points outwards
+  G4Tubs* block_solid =
+    new G4Tubs("TILE_BLOCK", r_min, r_max, lat_dimension_cell_ / 2.,
+               -step / 2., step);
+  G4LogicalVolume* block_logic =
+    new G4LogicalVolume(block_solid, active_logic_->GetMaterial(), "TILE_BLOCK");
+  new G4PVReplica("TILE_BLOCK", block_logic, ring_logic,
+                  kPhi, n_batches_per_row, step, pi / 2. - step / 2.);
+
+  // The ring and the blocks are part of the active LXe
+  for (auto logic : {ring_logic, block_logic}) {
+    logic->SetSensitiveDetector(active_logic_->GetSensitiveDetector());
+    logic->SetUserLimits(active_logic_->GetUserLimits());
+    logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+  }
+
+  G4RotationMatrix rot;
+  rot.rotateX(pi / 2.);
+  rot.rotateZ(-pi / 2.);
+
+  G4double y_pos = tile_sep / 2. + tile_dim_.x() / 2;
+  for (G4int j = 0; j < n_tile_rows_; j++)
+  {
+    G4double z_pos = -lat_dimension_cell_ / 2. + (j + 1. / 2.) * tile_dim_.y();
+    G4int copy_no = 1 + 2 * j * n_batches_per_row;
+    new G4PVPlacement(G4Transform3D(rot, G4ThreeVector(radius, -y_pos, z_pos)),
+                      tile_logic_, "TILE", block_logic, false, copy_no,
+                      check_overlaps);
+    new G4PVPlacement(G4Transform3D(rot, G4ThreeVector(radius, y_pos, z_pos)),
+                      tile_logic_, "TILE", block_logic, false, copy_no + 1,
+                      check_overlaps);
+  }
+}
+
 void FullRingTiles::BuildPhantom()
 {
+  InitProfiler::Scope profile("FullRingTiles::BuildPhantom");
+
+  G4bool check_overlaps = OverlapCheck::Instance().IsEnabled();
+
   G4Tubs* phantom_solid = new G4Tubs("PHANTOM", 0., phantom_diam_ / 2.,
                                      phantom_length_ / 2., 0, twopi);
   G4LogicalVolume* phantom_logic =
       new G4LogicalVolume(phantom_solid, materials::PEEK(), "PHANTOM");
   new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), phantom_logic,
-                    "PAHNTOM", lab_logic_, false, 0, true);
+                    "PAHNTOM", lab_logic_, false, 0, check_overlaps);
+}
+
+void FullRingTiles::BuildVoxelPhantom()
+{
+  InitProfiler::Scope profile("FullRingTiles::BuildVoxelPhantom");
+
+  G4bool check_overlaps = OverlapCheck::Instance().IsEnabled();
+
+  vox_phantom_->Construct();
+  new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), vox_phantom_->GetLogicalVolume(),
+                    "VOXEL_PHANTOM", lab_logic_, false, 0, check_overlaps);
 }
 
 G4ThreeVector FullRingTiles::GenerateVertex(const G4String &region) const
@@ -296,6 +504,19 @@ G4ThreeVector FullRingTiles::GenerateVertex(const G4String &region) const
   {
     vertex = cylindric_gen_->GenerateVertex("BODY_VOL");
   }
+  else if (region == "VOXEL_PHANTOM")
+  {
+    vertex = vox_phantom_->GenerateVertex("VOXEL_PHANTOM");
+  }
+  else if (region == "CUSTOM")
+  {
+    if (!point_gen_)
+    {
+      G4Exception("[FullRingTiles]", "GenerateVertex()", FatalException,
+                  "No point file given for the CUSTOM region.");
+    }
+    vertex = point_gen_->GenerateVertex();
+  }
   else
   {
     G4Exception("[FullRingTiles]", "GenerateVertex()", FatalException,
@@ -304,3 +525,14 @@ G4ThreeVector FullRingTiles::GenerateVertex(const G4String &region) const
 
   return vertex;
 }
+
+void FullRingTiles::AddPhotonSink(G4String volume)
+{
+  photon_sinks_.push_back(volume);
+}
+
+void FullRingTiles::BuildPointfile(G4String pointFile)
+{
+  delete point_gen_;
+  point_gen_ = new VoxelPointSampler(pointFile);
+}
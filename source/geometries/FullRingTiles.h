@@ -11,11 +11,14 @@
 #define FULL_RING_TILES_H
 
 #include "nexus/GeometryBase.h"
+#include <vector>
 
 class G4GenericMessenger;
 class G4LogicalVolume;
 
 class Tile;
+class VoxelPointSampler;
+class VoxelPhantom;
 namespace nexus
 {
   class CylinderPointSamplerLegacy;
@@ -36,10 +39,20 @@ public:
 
 private:
   void Construct();
+  void BuildGeometry();
+  /// Use a geometry read from the cache, attaching its sensitive detectors
+  void RestoreGeometry(G4LogicalVolume* lab_logic);
+  /// Create the regions with their own production cuts and step limits
+  void DefineRegions();
   void BuildCryostat();
   void BuildQuadSensors();
   void BuildSensors();
+  /// Same tiles as BuildSensors(), in blocks of two replicated in phi
+  void BuildReplicaSensors();
   void BuildPhantom();
+  void BuildVoxelPhantom();
+  void AddPhotonSink(G4String volume);
+  void BuildPointfile(G4String pointFile);
 
   Tile *tile_;
 
@@ -64,12 +77,21 @@ private:
   G4double phantom_diam_;
   G4double phantom_length_;
 
+  G4bool replica_blocks_; ///< Build the tiles as replicas in phi
+
+  G4bool voxel_phantom_;
+  VoxelPhantom *vox_phantom_;
+
   G4double max_step_size_;
 
   G4LogicalVolume *tile_logic_;
   G4ThreeVector tile_dim_;
 
   CylinderPointSamplerLegacy *cylindric_gen_;
+  VoxelPointSampler *point_gen_; ///< Generator of the CUSTOM region
+
+  /// Logical volumes where optical photons are killed
+  std::vector<G4String> photon_sinks_;
 };
 
 #endif
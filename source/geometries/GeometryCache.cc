@@ -0,0 +1,189 @@
+// ----------------------------------------------------------------------------
+// petalosim | GeometryCache.cc
+//
+// This class saves constructed geometries to GDML files, identified by
+// the geometry name and a hash of the values of all the /Geometry/
+// commands, the version of the code and the contents of the data files,
+// and reads them back in later jobs with the same configuration.
+// The geometries using it are responsible for attaching again their
+// sensitive detectors and user limits, which GDML does not store.
+// It needs Geant4 built with GDML support (PETALO_USE_GDML).
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "GeometryCache.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4UImanager.hh>
+#include <G4UIcommandTree.hh>
+#include <G4UIcommand.hh>
+#include <G4LogicalVolume.hh>
+
+#ifdef PETALO_USE_GDML
+#include <G4GDMLParser.hh>
+#endif
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// Set by the build from git describe
+#ifndef PETALO_VERSION
+#define PETALO_VERSION "unknown"
+#endif
+
+
+GeometryCache& GeometryCache::Instance()
+{
+  static GeometryCache instance;
+  return instance;
+}
+
+
+GeometryCache::GeometryCache(): cache_dir_("")
+{
+  msg_ = new G4GenericMessenger(this, "/petalosim/geometry/cache/",
+                                "Control commands of the geometry cache.");
+  msg_->DeclareProperty("directory", cache_dir_,
+                        "Directory where constructed geometries are cached.");
+}
+
+
+GeometryCache::~GeometryCache()
+{
+  delete msg_;
+}
+
+
+G4String GeometryCache::Key(const G4String& geometry_name,
+                            const std::vector<G4String>& ignored) const
+{
+  // The volumes also depend on the code and on the data files
+  // read while they are built, such as the material properties
+  G4String values = geometry_name + "\n" + PETALO_VERSION + "\n";
+  G4UIcommandTree* tree =
+    G4UImanager::GetUIpointer()->GetTree()->FindCommandTree("/Geometry/");
+  if (tree) AppendValues(tree, ignored, values);
+  AppendDataFiles(values);
+
+  // FNV-1a, which gives the same hash on every platform
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : values) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream key;
+  key << geometry_name << "_" << std::hex << std::setw(16)
+      << std::setfill('0') << hash;
+  return key.str();
+}
+
+
+void GeometryCache::AppendValues(G4UIcommandTree* tree,
+                                 const std::vector<G4String>& ignored,
+                                 G4String& values) const
+{
+  G4UImanager* ui = G4UImanager::GetUIpointer();
+
+  // Entries of command trees are numbered from 1
+  for (G4int i=1; i<=tree->GetCommandEntry(); ++i) {
+    G4String path = tree->GetCommand(i)->GetCommandPath();
+    if (std::find(ignored.begin(), ignored.end(), path) != ignored.end())
+      continue;
+    values += path + " " + ui->GetCurrentValues(path) + "\n";
+  }
+  for (G4int i=1; i<=tree->GetTreeEntry(); ++i)
+    AppendValues(tree->GetTree(i), ignored, values);
+}
+
+
+void GeometryCache::AppendDataFiles(G4String& values) const
+{
+  char* petalodir = std::getenv("PETALODIR");
+  if (!petalodir) return;
+
+  std::filesystem::path data_dir = std::filesystem::path(petalodir) / "data";
+  if (!std::filesystem::is_directory(data_dir)) return;
+
+  // Sorted, since the order of the directory entries is not specified
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(data_dir))
+    if (entry.is_regular_file()) files.push_back(entry.path());
+  std::sort(files.begin(), files.end());
+
+  for (const auto& file : files) {
+    std::ifstream in(file, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    values += file.filename().string() + "\n" + contents.str() + "\n";
+  }
+}
+
+
+G4String GeometryCache::FileName(const G4String& key) const
+{
+  return (std::filesystem::path(cache_dir_) / (key + ".gdml")).string();
+}
+
+
+#ifdef PETALO_USE_GDML
+
+G4LogicalVolume* GeometryCache::Load(const G4String& key,
+                                     const G4String& top_name) const
+{
+  G4String file = FileName(key);
+  if (!std::filesystem::exists(file)) return nullptr;
+
+  G4GDMLParser parser;
+  parser.Read(file, false);
+  G4cout << "[GeometryCache] Geometry read from " << file << G4endl;
+
+  // The top volume is placed by the detector construction,
+  // so the world volume of the file is not used
+  return parser.GetVolume(top_name);
+}
+
+
+void GeometryCache::Save(const G4String& key, const G4LogicalVolume* top) const
+{
+  // The file is written under a temporary name and then renamed,
+  // so that concurrent jobs never read an incomplete geometry
+  G4String file = FileName(key);
+  G4String tmp_file = file + ".tmp." + std::to_string(getpid());
+
+  std::filesystem::create_directories(cache_dir_);
+
+  G4GDMLParser parser;
+  parser.Write(tmp_file, top);
+
+  if (std::rename(tmp_file.c_str(), file.c_str()) != 0)
+    std::remove(tmp_file.c_str());
+  else
+    G4cout << "[GeometryCache] Geometry saved to " << file << G4endl;
+}
+
+#else
+
+G4LogicalVolume* GeometryCache::Load(const G4String&, const G4String&) const
+{
+  G4Exception("[GeometryCache]", "Load()", JustWarning,
+              "petalosim was built without GDML support, "
+              "the geometry cache is ignored.");
+  return nullptr;
+}
+
+
+void GeometryCache::Save(const G4String&, const G4LogicalVolume*) const
+{
+}
+
+#endif
@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------
+// petalosim | GeometryCache.h
+//
+// This class saves constructed geometries to GDML files, identified by
+// the geometry name and a hash of the values of all the /Geometry/
+// commands, the version of the code and the contents of the data files,
+// and reads them back in later jobs with the same configuration.
+// The geometries using it are responsible for attaching again their
+// sensitive detectors and user limits, which GDML does not store.
+// It needs Geant4 built with GDML support (PETALO_USE_GDML).
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef GEOMETRY_CACHE_H
+#define GEOMETRY_CACHE_H
+
+#include <globals.hh>
+
+#include <vector>
+
+class G4GenericMessenger;
+class G4LogicalVolume;
+class G4UIcommandTree;
+
+class GeometryCache
+{
+public:
+  static GeometryCache& Instance();
+
+  /// Is a cache directory set?
+  G4bool IsEnabled() const;
+
+  /// Return the key of the geometry with the current configuration.
+  /// Commands with the given full paths (such as those of the vertex
+  /// generation) do not change the volumes and are not included.
+  G4String Key(const G4String& geometry_name,
+               const std::vector<G4String>& ignored = {}) const;
+
+  /// Return the top logical volume, with the given name, of the cached
+  /// geometry, or nullptr if it is not in the cache
+  G4LogicalVolume* Load(const G4String& key, const G4String& top_name) const;
+  /// Add a constructed geometry to the cache
+  void Save(const G4String& key, const G4LogicalVolume* top) const;
+
+private:
+  GeometryCache();
+  ~GeometryCache();
+
+  G4String FileName(const G4String& key) const;
+  /// Append the path and value of all the commands below a directory
+  void AppendValues(G4UIcommandTree* tree, const std::vector<G4String>& ignored,
+                    G4String& values) const;
+  /// Append the name and contents of the files in $PETALODIR/data
+  void AppendDataFiles(G4String& values) const;
+
+  G4GenericMessenger* msg_;
+  G4String cache_dir_; ///< Directory of the cached geometries
+};
+
+inline G4bool GeometryCache::IsEnabled() const
+{
+  return cache_dir_ != "";
+}
+
+#endif
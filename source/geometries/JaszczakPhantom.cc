@@ -7,6 +7,7 @@
 // ----------------------------------------------------------------------------
 
 #include "JaszczakPhantom.h"
+#include "InitProfiler.h"
 
 #include "nexus/FactoryBase.h"
 #include "nexus/Visibilities.h"
@@ -21,8 +22,11 @@
 #include <G4RotationMatrix.hh>
 #include <G4VisAttributes.hh>
 #include <G4GenericMessenger.hh>
-#include <G4TransportationManager.hh>
-#include <G4Navigator.hh>
+#include <G4RandomDirection.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
 
 using namespace nexus;
 
@@ -56,10 +60,6 @@ JaszczakPhantom::JaszczakPhantom(): GeometryBase(),
   msg_->DeclareProperty("bckg_activity",   bckg_activity_,   "Activity of the background of the phantom");
   msg_->DeclareProperty("sphere_activity", sphere_activity_, "Activity of the spheres");
   msg_->DeclareProperty("rod_activity",    rod_activity_,    "Activity of the rods");
-
-  /// Initializing the geometry navigator (used in vertex generation)
-  geom_navigator_ =
-    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
 }
 
 
@@ -115,7 +115,15 @@ void JaszczakPhantom::Construct()
   }
 
   // Relative actvities
+  if (bckg_activity_ < 0. || sphere_activity_ < 0. || rod_activity_ < 0.) {
+    G4Exception("[JaszczakPhantom]", "Construct()", FatalException,
+                "The activities of the phantom cannot be negative.");
+  }
   auto max_activity = std::max(sphere_activity_, std::max(bckg_activity_, rod_activity_));
+  if (!(max_activity > 0.)) {
+    G4Exception("[JaszczakPhantom]", "Construct()", FatalException,
+                "The activity of all the regions of the phantom is zero.");
+  }
   bckg_activity_   /= max_activity;
   sphere_activity_ /= max_activity;
   rod_activity_    /= max_activity;
@@ -123,12 +131,15 @@ void JaszczakPhantom::Construct()
   G4cout << "*** Relative activities (background, spheres, rods) ***" << G4endl;
   G4cout << bckg_activity_ << ", " << sphere_activity_  << ", " << rod_activity_ << G4endl;
 
+  ComputeRegionCDF();
 }
 
 
 void JaszczakPhantom::BuildSpheres(unsigned long n, G4double r, G4double r_pos, G4double z_pos,
-                                   G4LogicalVolume* mother_logic, G4Material* mat) const
+                                   G4LogicalVolume* mother_logic, G4Material* mat)
 {
+  InitProfiler::Scope profile("JaszczakPhantom::BuildSpheres");
+
   auto sphere_name = "SPHERE" + std::to_string(n);
   auto sphere_solid = new G4Orb(sphere_name, r);
   auto sphere_logic = new G4LogicalVolume(sphere_solid, mat, sphere_name);
@@ -137,13 +148,18 @@ void JaszczakPhantom::BuildSpheres(unsigned long n, G4double r, G4double r_pos,
   auto y_pos = r_pos * sin(angle);
   new G4PVPlacement(0, G4ThreeVector(x_pos, y_pos, z_pos), sphere_logic,
                     sphere_name, mother_logic, false, 0, false);
+
+  sphere_pos_.push_back(G4ThreeVector(x_pos, y_pos, z_pos));
+  sphere_r_.push_back(r);
 }
 
 
 
 void JaszczakPhantom::BuildRods(unsigned long n, G4double r, G4double z_pos,
-                                G4LogicalVolume* mother_logic, G4Material* mat) const
+                                G4LogicalVolume* mother_logic, G4Material* mat)
   {
+    InitProfiler::Scope profile("JaszczakPhantom::BuildRods");
+
     auto diam = 2 * r;
 
     // Sector displacement from centre, to accommodate gap between sectors
@@ -172,6 +188,8 @@ void JaszczakPhantom::BuildRods(unsigned long n, G4double r, G4double z_pos,
         G4ThreeVector pos = G4ThreeVector(x_pos, y_pos, z_pos);
         G4ThreeVector newpos = pos.rotateZ(n*pi/3);
         new G4PVPlacement(0, newpos, rod_logic, label, mother_logic, false, 0, false);
+        rod_pos_.push_back(newpos);
+        rod_r_.push_back(r);
 
         G4VisAttributes col = nexus::Blue();
         col.SetForceSolid(true);
@@ -181,23 +199,85 @@ void JaszczakPhantom::BuildRods(unsigned long n, G4double r, G4double z_pos,
   }
 
 
+void JaszczakPhantom::ComputeRegionCDF()
+{
+  // Each region is chosen with probability proportional to its
+  // activity times its volume
+  G4double bckg_volume = pi * std::pow(cylinder_inner_diam_/2., 2) * cylinder_height_;
+
+  std::vector<G4double> weights(1, 0.);
+  for (auto r : sphere_r_) {
+    G4double volume = 4./3. * pi * std::pow(r, 3);
+    bckg_volume -= volume;
+    weights.push_back(sphere_activity_ * volume);
+  }
+  for (auto r : rod_r_) {
+    G4double volume = pi * r * r * rod_height_;
+    bckg_volume -= volume;
+    weights.push_back(rod_activity_ * volume);
+  }
+  weights[0] = bckg_activity_ * bckg_volume;
+
+  region_cdf_.clear();
+  G4double sum = 0.;
+  for (auto w : weights) {
+    sum += w;
+    region_cdf_.push_back(sum);
+  }
+
+  // Written so that a NaN sum is also rejected
+  if (!(sum > 0.)) {
+    G4Exception("[JaszczakPhantom]", "ComputeRegionCDF()", FatalException,
+                "The activity of all the regions of the phantom is zero.");
+  }
+
+  for (auto& c : region_cdf_) c /= sum;
+}
+
+
+G4bool JaszczakPhantom::InsideInsert(const G4ThreeVector& point) const
+{
+  for (unsigned long i=0; i<sphere_pos_.size(); i++) {
+    if ((point - sphere_pos_[i]).mag2() < sphere_r_[i] * sphere_r_[i]) return true;
+  }
+
+  auto rod_z = - cylinder_height_/2. + rod_height_/2;
+  if (std::abs(point.z() - rod_z) > rod_height_/2) return false;
+  for (unsigned long i=0; i<rod_pos_.size(); i++) {
+    auto dx = point.x() - rod_pos_[i].x();
+    auto dy = point.y() - rod_pos_[i].y();
+    if (dx*dx + dy*dy < rod_r_[i] * rod_r_[i]) return true;
+  }
+
+  return false;
+}
+
+
 G4ThreeVector JaszczakPhantom::GenerateVertex(const G4String &/*region*/) const
 {
-  G4ThreeVector vertex(0, 0, 0);
-  G4VPhysicalVolume* VertexVolume;
-
-  while (true) {
-    vertex = cyl_gen_->GenerateVertex(VOLUME);
-    VertexVolume = geom_navigator_->LocateGlobalPointAndSetup(vertex, 0, false);
-    G4String vol_name = VertexVolume->GetName();
-
-    if (G4StrUtil::starts_with(vol_name, "WATER_BCKG")) {
-      if (((float)std::rand() / (float)RAND_MAX) < bckg_activity_) return vertex;
-    } else if (G4StrUtil::starts_with(vol_name, "SPHERE")) {
-      if (((float)std::rand() / (float)RAND_MAX) < sphere_activity_) return vertex;
-    } else if (G4StrUtil::starts_with(vol_name, "ROD")) {
-      if (((float)std::rand() / (float)RAND_MAX) < rod_activity_) return vertex;
-    }
+  auto it = std::upper_bound(region_cdf_.begin(), region_cdf_.end(), G4UniformRand());
+  unsigned long region = std::min<unsigned long>(it - region_cdf_.begin(),
+                                                 region_cdf_.size() - 1);
+
+  if (region == 0) {
+    // The inserts fill a small fraction of the cylinder,
+    // so few points are rejected
+    G4ThreeVector vertex;
+    do {
+      vertex = cyl_gen_->GenerateVertex(VOLUME);
+    } while (InsideInsert(vertex));
+    return vertex;
+  }
+
+  region -= 1;
+  if (region < sphere_pos_.size()) {
+    auto r = sphere_r_[region] * std::cbrt(G4UniformRand());
+    return sphere_pos_[region] + r * G4RandomDirection();
   }
 
+  region -= sphere_pos_.size();
+  auto r   = rod_r_[region] * std::sqrt(G4UniformRand());
+  auto phi = twopi * G4UniformRand();
+  auto z   = (G4UniformRand() - 0.5) * rod_height_;
+  return rod_pos_[region] + G4ThreeVector(r * cos(phi), r * sin(phi), z);
 }
@@ -11,9 +11,10 @@
 
 #include "nexus/GeometryBase.h"
 
+#include <vector>
+
 class G4Material;
 class G4GenericMessenger;
-class G4Navigator;
 
 namespace nexus
 {
@@ -37,15 +38,26 @@ class JaszczakPhantom: public GeometryBase
  private:
 
   void BuildSpheres(unsigned long n, G4double r, G4double r_pos, G4double z_pos,
-                 G4LogicalVolume* mother_logic, G4Material* mat) const;
+                 G4LogicalVolume* mother_logic, G4Material* mat);
   void BuildRods(unsigned long n, G4double r, G4double z_pos,
-                 G4LogicalVolume* mother_logic, G4Material* mat) const;
+                 G4LogicalVolume* mother_logic, G4Material* mat);
+
+  /// Fill the cumulative distribution of activity x volume of the regions
+  void ComputeRegionCDF();
+  /// Is the point inside any sphere or rod?
+  G4bool InsideInsert(const G4ThreeVector& point) const;
 
   G4GenericMessenger *msg_;
-  G4Navigator* geom_navigator_;
 
   CylinderPointSampler* cyl_gen_;
 
+  // Regions of the vertex generation: background (0), spheres and rods
+  std::vector<G4ThreeVector> sphere_pos_;
+  std::vector<G4double> sphere_r_;
+  std::vector<G4ThreeVector> rod_pos_;
+  std::vector<G4double> rod_r_;
+  std::vector<G4double> region_cdf_;
+
   G4double bckg_activity_;
   G4double sphere_activity_;
   G4double rod_activity_;
@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------------
+// petalosim | OverlapCheck.cc
+//
+// Global switch of the overlap checks done when volumes are placed.
+// The checks sample thousands of points on the surface of every placed
+// solid, so they are disabled by default and are meant to be switched on
+// only when a geometry is being developed or changed.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OverlapCheck.h"
+
+#include <G4GenericMessenger.hh>
+
+
+OverlapCheck& OverlapCheck::Instance()
+{
+  static OverlapCheck instance;
+  return instance;
+}
+
+
+OverlapCheck::OverlapCheck(): enabled_(false)
+{
+  msg_ = new G4GenericMessenger(this, "/petalosim/geometry/overlaps/",
+                                "Control commands of the overlap checks.");
+  msg_->DeclareProperty("check", enabled_,
+                        "Check the overlaps of the placed volumes.");
+}
+
+
+OverlapCheck::~OverlapCheck()
+{
+  delete msg_;
+}
@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// petalosim | OverlapCheck.h
+//
+// Global switch of the overlap checks done when volumes are placed.
+// The checks sample thousands of points on the surface of every placed
+// solid, so they are disabled by default and are meant to be switched on
+// only when a geometry is being developed or changed.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OVERLAP_CHECK_H
+#define OVERLAP_CHECK_H
+
+#include <globals.hh>
+
+class G4GenericMessenger;
+
+class OverlapCheck
+{
+public:
+  static OverlapCheck& Instance();
+
+  /// Must the overlaps of the placed volumes be checked?
+  G4bool IsEnabled() const;
+
+private:
+  OverlapCheck();
+  ~OverlapCheck();
+
+  G4GenericMessenger* msg_;
+  G4bool enabled_;
+};
+
+inline G4bool OverlapCheck::IsEnabled() const
+{
+  return enabled_;
+}
+
+#endif
@@ -11,9 +11,11 @@
 #include "TileHamamatsuVUV.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "TeflonBlockHamamatsu.h"
 #include "PetaloUtils.h"
 #include "PetIonizationSD.h"
+#include "InitProfiler.h"
 
 #include "nexus/Visibilities.h"
 #include "nexus/FactoryBase.h"
@@ -94,8 +96,11 @@ void PETit::Construct()
 
 void PETit::BuildBox()
 {
+  InitProfiler::Scope profile("PETit::BuildBox");
+
   G4Material* LXe = G4NistManager::Instance()->FindOrBuildMaterial("G4_lXe");
-  LXe->SetMaterialPropertiesTable(petopticalprops::LXe(pressure_));
+  LXe->SetMaterialPropertiesTable(
+    OpticalRegistry::Instance().Table("LXe", petopticalprops::LXe, pressure_));
 
   // Set the ACTIVE volume as an ionization sensitive det
   PetIonizationSD* ionisd = new PetIonizationSD("/PETALO/ACTIVE");
@@ -150,6 +155,8 @@ void PETit::BuildBox()
 
 void PETit::BuildSensors()
 {
+  InitProfiler::Scope profile("PETit::BuildSensors");
+
   TileHamamatsuVUV tile = TileHamamatsuVUV();
   tile.SetBoxConf(hama);
   tile.SetTileVisibility(tile_vis_);
@@ -11,9 +11,11 @@
 #include "TileFBK.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "TeflonBlockFBK.h"
 #include "PetaloUtils.h"
 #include "PetIonizationSD.h"
+#include "InitProfiler.h"
 
 #include "nexus/Visibilities.h"
 #include "nexus/FactoryBase.h"
@@ -94,8 +96,11 @@ void PETitFBK::Construct()
 
 void PETitFBK::BuildBox()
 {
+  InitProfiler::Scope profile("PETitFBK::BuildBox");
+
   G4Material* LXe = G4NistManager::Instance()->FindOrBuildMaterial("G4_lXe");
-  LXe->SetMaterialPropertiesTable(petopticalprops::LXe(pressure_));
+  LXe->SetMaterialPropertiesTable(
+    OpticalRegistry::Instance().Table("LXe", petopticalprops::LXe, pressure_));
 
   // Set the ACTIVE volume as an ionization sensitive det
   PetIonizationSD* ionisd = new PetIonizationSD("/PETALO/ACTIVE");
@@ -152,6 +157,8 @@ void PETitFBK::BuildBox()
 
 void PETitFBK::BuildSensors()
 {
+  InitProfiler::Scope profile("PETitFBK::BuildSensors");
+
   TileFBK tile = TileFBK();
   tile.SetBoxConf(fbk);
   tile.SetNamingOrder(100);
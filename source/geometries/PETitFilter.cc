@@ -12,10 +12,12 @@
 #include "TileHamamatsuVUV.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "TeflonBlockHamamatsu.h"
 #include "TeflonBlockHamamatsuFilter.h"
 #include "PetaloUtils.h"
 #include "NeutralFilterVUV.h"
+#include "InitProfiler.h"
 #include "nexus/Visibilities.h"
 #include "nexus/IonizationSD.h"
 #include "nexus/FactoryBase.h"
@@ -96,8 +98,11 @@ void PETitFilter::Construct()
 
 void PETitFilter::BuildBox()
 {
+  InitProfiler::Scope profile("PETitFilter::BuildBox");
+
   G4Material* LXe = G4NistManager::Instance()->FindOrBuildMaterial("G4_lXe");
-  LXe->SetMaterialPropertiesTable(petopticalprops::LXe(pressure_));
+  LXe->SetMaterialPropertiesTable(
+    OpticalRegistry::Instance().Table("LXe", petopticalprops::LXe, pressure_));
 
   // Set the ACTIVE volume as an ionization sensitive det
   IonizationSD* ionisd = new IonizationSD("/PETALO/ACTIVE");
@@ -187,6 +192,8 @@ void PETitFilter::BuildBox()
 
 void PETitFilter::BuildSensors()
 {
+  InitProfiler::Scope profile("PETitFilter::BuildSensors");
+
   TileHamamatsuVUV tile = TileHamamatsuVUV();
   tile.SetBoxConf(hama);
   tile.SetTileVisibility(tile_vis_);
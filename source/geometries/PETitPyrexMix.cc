@@ -16,9 +16,11 @@
 #include "TileFBK.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "TeflonBlockHamamatsu.h"
 #include "PetaloUtils.h"
 #include "PetIonizationSD.h"
+#include "InitProfiler.h"
 
 #include "nexus/Visibilities.h"
 #include "nexus/FactoryBase.h"
@@ -115,8 +117,11 @@ void PETitPyrexMix::Construct()
 
 void PETitPyrexMix::BuildBox()
 {
+  InitProfiler::Scope profile("PETitPyrexMix::BuildBox");
+
   G4Material* LXe = G4NistManager::Instance()->FindOrBuildMaterial("G4_lXe");
-  LXe->SetMaterialPropertiesTable(petopticalprops::LXe(pressure_));
+  LXe->SetMaterialPropertiesTable(
+    OpticalRegistry::Instance().Table("LXe", petopticalprops::LXe, pressure_));
 
   // Set the ACTIVE volume as an ionization sensitive det
   PetIonizationSD* ionisd = new PetIonizationSD("/PETALO/ACTIVE");
@@ -236,12 +241,11 @@ void PETitPyrexMix::BuildBox()
                     false, 4, false);
 
   // Optical surface for the panels
-  G4OpticalSurface* panel_opsur = new G4OpticalSurface("OP_PANEL");
-  panel_opsur->SetType(dielectric_metal);
-  panel_opsur->SetModel(unified);
-  panel_opsur->SetFinish(ground);
-  panel_opsur->SetSigmaAlpha(0.1);
-  panel_opsur->SetMaterialPropertiesTable(petopticalprops::ReflectantSurface(reflectivity_));
+  OpticalRegistry& optreg = OpticalRegistry::Instance();
+  G4MaterialPropertiesTable* panel_opsur_mpt =
+    optreg.Table("ReflectantSurface", petopticalprops::ReflectantSurface, reflectivity_);
+  G4OpticalSurface* panel_opsur =
+    optreg.Surface("OP_PANEL", unified, ground, dielectric_metal, panel_opsur_mpt, 0.1);
   new G4LogicalSkinSurface("OP_PANEL", entry_panel_logic, panel_opsur);
   new G4LogicalSkinSurface("OP_PANEL_H", h_l_panel_logic, panel_opsur);
   new G4LogicalSkinSurface("OP_PANEL_V", v_l_panel_logic, panel_opsur);
@@ -257,6 +261,7 @@ void PETitPyrexMix::BuildBox()
 
 void PETitPyrexMix::BuildSensors()
 {
+  InitProfiler::Scope profile("PETitPyrexMix::BuildSensors");
 
   // Construct here the tiles to use their distance to flange
   TileHamamatsuVUV tile0 = TileHamamatsuVUV();
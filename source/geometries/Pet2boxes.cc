@@ -10,6 +10,7 @@
 #include "PetKDBFixedPitch.h"
 #include "PetPlainDice.h"
 #include "PetIonizationSD.h"
+#include "InitProfiler.h"
 
 #include "nexus/BoxPointSamplerLegacy.h"
 #include "nexus/OpticalMaterialProperties.h"
@@ -108,6 +109,8 @@ void Pet2boxes::Construct()
 
 void Pet2boxes::BuildDetector()
 {
+  InitProfiler::Scope profile("Pet2boxes::BuildDetector");
+
   G4double det_size = active_size_ + 2. * db_z_ + 2. * det_thickness_;
   G4double det_size2 = z_size_ + 2. * db_z_ + 2. * det_thickness_;
   G4Box *det_solid =
@@ -124,6 +127,8 @@ void Pet2boxes::BuildDetector()
 
 void Pet2boxes::BuildLXe()
 {
+  InitProfiler::Scope profile("Pet2boxes::BuildLXe");
+
   G4double lXe_size = active_size_ + 2. * db_z_;
   G4double lXe_size2 = z_size_ + 2. * db_z_;
   G4Box* lXe_solid =
@@ -137,6 +142,8 @@ void Pet2boxes::BuildLXe()
 
 void Pet2boxes::BuildActive()
 {
+  InitProfiler::Scope profile("Pet2boxes::BuildActive");
+
   G4Box* active_solid =
       new G4Box("ACTIVE", active_size_ / 2., active_size_ / 2., z_size_ / 2.);
 
@@ -162,6 +169,8 @@ void Pet2boxes::BuildActive()
 
 void Pet2boxes::BuildSiPMPlane()
 {
+  InitProfiler::Scope profile("Pet2boxes::BuildSiPMPlane");
+
   pdb_->SetSize(z_size_, active_size_);
   pdb_->Construct();
 
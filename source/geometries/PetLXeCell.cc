@@ -12,6 +12,7 @@
 #include "PetPlainDice.h"
 #include "PetOpticalMaterialProperties.h"
 #include "PetIonizationSD.h"
+#include "InitProfiler.h"
 
 #include "nexus/BoxPointSamplerLegacy.h"
 #include "nexus/Visibilities.h"
@@ -158,6 +159,8 @@ void PetLXeCell::Construct()
 
 void PetLXeCell::BuildLXe()
 {
+  InitProfiler::Scope profile("PetLXeCell::BuildLXe");
+
   G4double lXe_size_xy = xy_size_ + 2. * pdb_z_ + 30. * cm;
   lXe_size_z_ = z_size_ + 2. * pdb_z_ + z_LXe_;
   G4Box* lXe_solid =
@@ -175,6 +178,8 @@ void PetLXeCell::BuildLXe()
 
 void PetLXeCell::BuildActive()
 {
+  InitProfiler::Scope profile("PetLXeCell::BuildActive");
+
   G4Box* active_solid =
       new G4Box("ACTIVE", xy_size_ / 2., xy_size_ / 2., z_size_ / 2.);
 
@@ -200,6 +205,8 @@ void PetLXeCell::BuildActive()
 
 void PetLXeCell::BuildSiPMPlane()
 {
+  InitProfiler::Scope profile("PetLXeCell::BuildSiPMPlane");
+
   G4cout << "Active size = " << xy_size_ << ", " << z_size_ << G4endl;
   sipm_pitch_ = xy_size_ / rows_;
   G4LogicalVolume *sipm_logic = sipm_->GetLogicalVolume();
@@ -14,6 +14,7 @@
 #include "SiPMpetVUV.h"
 #include "SiPMpetTPB.h"
 #include "PetIonizationSD.h"
+#include "InitProfiler.h"
 
 #include "nexus/BoxPointSamplerLegacy.h"
 #include "nexus/MaterialsList.h"
@@ -133,6 +134,8 @@ void PetLYSOCell::Construct()
 
 void PetLYSOCell::BuildDetector()
 {
+  InitProfiler::Scope profile("PetLYSOCell::BuildDetector");
+
   G4double det_size = active_size_ + 2. * pdb_z_ + 2. * det_thickness_;
   G4double det_size2 =
       z_size_ + 2. * sipm_->GetDimensions().z() + 2. * det_thickness_;
@@ -150,6 +153,8 @@ void PetLYSOCell::BuildDetector()
 
 void PetLYSOCell::BuildLYSO()
 {
+  InitProfiler::Scope profile("PetLYSOCell::BuildLYSO");
+
   G4double lyso_size = active_size_ + 2. * pdb_z_;
   G4double lyso_size2 = z_size_ + 2. * sipm_->GetDimensions().z();
   G4Box* lyso_solid =
@@ -163,6 +168,8 @@ void PetLYSOCell::BuildLYSO()
 
 void PetLYSOCell::BuildActive()
 {
+  InitProfiler::Scope profile("PetLYSOCell::BuildActive");
+
   G4Box* active_solid =
       new G4Box("ACTIVE_LYSO", active_size_ / 2., active_size_ / 2., z_size_ / 2.);
   // G4Box* active_solid =
@@ -191,6 +198,7 @@ void PetLYSOCell::BuildActive()
 
 void PetLYSOCell::BuildSiPMPlane()
 {
+  InitProfiler::Scope profile("PetLYSOCell::BuildSiPMPlane");
 
   G4int rows = 8;
   G4int columns = 8;
@@ -0,0 +1,54 @@
+// ----------------------------------------------------------------------------
+// petalosim | PetUserLimits.cc
+//
+// User limits with a maximum step length that can be different for each
+// particle type. Particles without a specific value use the default one.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PetUserLimits.h"
+
+#include <G4ParticleTable.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4Track.hh>
+
+
+PetUserLimits::PetUserLimits(G4double max_step): G4UserLimits(max_step)
+{
+}
+
+
+PetUserLimits::~PetUserLimits()
+{
+}
+
+
+void PetUserLimits::SetMaxAllowedStep(const G4String& particle, G4double max_step)
+{
+  const G4ParticleDefinition* def =
+    G4ParticleTable::GetParticleTable()->FindParticle(particle);
+  if (!def) {
+    G4Exception("[PetUserLimits]", "SetMaxAllowedStep()", FatalErrorInArgument,
+                ("Unknown particle " + particle).c_str());
+    return;
+  }
+
+  for (auto& ps : particle_steps_) {
+    if (ps.first == def) {
+      ps.second = max_step;
+      return;
+    }
+  }
+  particle_steps_.emplace_back(def, max_step);
+}
+
+
+G4double PetUserLimits::GetMaxAllowedStep(const G4Track& track)
+{
+  const G4ParticleDefinition* def = track.GetParticleDefinition();
+  for (const auto& ps : particle_steps_)
+    if (ps.first == def) return ps.second;
+
+  return G4UserLimits::GetMaxAllowedStep(track);
+}
@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------------
+// petalosim | PetUserLimits.h
+//
+// User limits with a maximum step length that can be different for each
+// particle type. Particles without a specific value use the default one.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PET_USER_LIMITS_H
+#define PET_USER_LIMITS_H
+
+#include <G4UserLimits.hh>
+
+#include <utility>
+#include <vector>
+
+class G4ParticleDefinition;
+
+class PetUserLimits: public G4UserLimits
+{
+public:
+  PetUserLimits(G4double max_step = DBL_MAX);
+  ~PetUserLimits();
+
+  /// Set the maximum step of the particle with the given name
+  void SetMaxAllowedStep(const G4String& particle, G4double max_step);
+
+  G4double GetMaxAllowedStep(const G4Track& track) override;
+
+private:
+  /// Usually a handful of particles, so a linear search is the fastest
+  std::vector<std::pair<const G4ParticleDefinition*, G4double>> particle_steps_;
+};
+
+#endif
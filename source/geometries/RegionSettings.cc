@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------------
+// petalosim | RegionSettings.cc
+//
+// This class keeps the production cuts and the maximum step lengths
+// configured for the regions of the detector (phantom, active LXe, passive
+// structure and sensors), and applies them to the G4Regions created by the
+// geometries. Each region has its own messenger directory, for instance
+// /petalosim/regions/PASSIVE/production_cut. The step limits only have
+// effect for particles with a step limiter process.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "RegionSettings.h"
+#include "PetUserLimits.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
+#include <G4ProductionCuts.hh>
+#include <G4ProductionCutsTable.hh>
+
+
+RegionSettings::RegionMessenger::RegionMessenger(RegionSettings* settings,
+                                                 const G4String& region):
+  settings_(settings), region_(region), particle_("all"), production_cut_(-1.)
+{
+  msg_ = new G4GenericMessenger(this, "/petalosim/regions/" + region + "/",
+                                "Control commands of the region " + region + ".");
+
+  G4GenericMessenger::Command& cut_cmd =
+    msg_->DeclarePropertyWithUnit("production_cut", "mm", production_cut_,
+                                  "Production cut of all the particles.");
+  cut_cmd.SetParameterName("production_cut", false);
+  cut_cmd.SetRange("production_cut>0.");
+
+  msg_->DeclareMethod("particle", &RegionMessenger::SetParticle,
+                      "Particle of the following max_step commands (all by default).");
+
+  G4GenericMessenger::Command& step_cmd =
+    msg_->DeclareMethodWithUnit("max_step", "mm", &RegionMessenger::SetMaxStep,
+                                "Maximum step length of the selected particle.");
+  step_cmd.SetParameterName("max_step", false);
+  step_cmd.SetRange("max_step>0.");
+}
+
+
+RegionSettings::RegionMessenger::~RegionMessenger()
+{
+  delete msg_;
+}
+
+
+void RegionSettings::RegionMessenger::SetParticle(G4String particle)
+{
+  particle_ = particle;
+}
+
+
+void RegionSettings::RegionMessenger::SetMaxStep(G4double max_step)
+{
+  auto& steps = settings_->max_steps_[region_];
+  for (auto& ps : steps) {
+    if (ps.first == particle_) {
+      ps.second = max_step;
+      return;
+    }
+  }
+  steps.emplace_back(particle_, max_step);
+}
+
+
+RegionSettings& RegionSettings::Instance()
+{
+  static RegionSettings instance;
+  return instance;
+}
+
+
+const std::vector<G4String>& RegionSettings::RegionNames()
+{
+  static const std::vector<G4String> names =
+    {"PHANTOM", "ACTIVE", "PASSIVE", "SENSORS"};
+  return names;
+}
+
+
+RegionSettings::RegionSettings()
+{
+  for (const auto& name : RegionNames())
+    messengers_.push_back(new RegionMessenger(this, name));
+}
+
+
+RegionSettings::~RegionSettings()
+{
+  for (auto msg : messengers_) delete msg;
+}
+
+
+void RegionSettings::DefineRegion(const G4String& name,
+                                  const std::vector<G4LogicalVolume*>& roots)
+{
+  G4Region* region = G4RegionStore::GetInstance()->FindOrCreateRegion(name);
+  for (auto lv : roots)
+    if (lv) region->AddRootLogicalVolume(lv);
+
+  // Regions without a cut of their own share the default cuts, which
+  // follow /run/setCut; otherwise the kernel warns that they have none
+  G4ProductionCuts* cuts =
+    G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+  for (auto msg : messengers_) {
+    if (msg->region_ == name && msg->production_cut_ > 0.) {
+      cuts = new G4ProductionCuts();
+      cuts->SetProductionCut(msg->production_cut_);
+      G4cout << "[RegionSettings] Production cut in region " << name
+             << " = " << msg->production_cut_ / mm << " mm" << G4endl;
+    }
+  }
+  region->SetProductionCuts(cuts);
+
+  if (max_steps_.count(name) == 0) return;
+
+  G4UserLimits* limits = StepLimits(name);
+  for (auto lv : roots)
+    if (lv) ApplyStepLimits(lv, limits);
+}
+
+
+G4UserLimits* RegionSettings::StepLimits(const G4String& name,
+                                         G4double max_step) const
+{
+  auto it = max_steps_.find(name);
+  if (it == max_steps_.end()) {
+    if (max_step == DBL_MAX) return nullptr;
+    return new PetUserLimits(max_step);
+  }
+
+  // The default of the region has priority over the one of the geometry
+  for (const auto& ps : it->second)
+    if (ps.first == "all") max_step = ps.second;
+
+  PetUserLimits* limits = new PetUserLimits(max_step);
+  for (const auto& ps : it->second)
+    if (ps.first != "all") limits->SetMaxAllowedStep(ps.first, ps.second);
+  return limits;
+}
+
+
+void RegionSettings::ApplyStepLimits(G4LogicalVolume* lv,
+                                     G4UserLimits* limits) const
+{
+  if (!lv->GetUserLimits()) lv->SetUserLimits(limits);
+
+  for (std::size_t i=0; i<lv->GetNoDaughters(); ++i) {
+    G4LogicalVolume* daughter = lv->GetDaughter(i)->GetLogicalVolume();
+    // Daughters defining their own region are left untouched
+    if (daughter->IsRootRegion()) continue;
+    ApplyStepLimits(daughter, limits);
+  }
+}
@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------------
+// petalosim | RegionSettings.h
+//
+// This class keeps the production cuts and the maximum step lengths
+// configured for the regions of the detector (phantom, active LXe, passive
+// structure and sensors), and applies them to the G4Regions created by the
+// geometries. Each region has its own messenger directory, for instance
+// /petalosim/regions/PASSIVE/production_cut. The step limits only have
+// effect for particles with a step limiter process.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef REGION_SETTINGS_H
+#define REGION_SETTINGS_H
+
+#include <globals.hh>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class G4GenericMessenger;
+class G4LogicalVolume;
+class G4UserLimits;
+
+class RegionSettings
+{
+public:
+  static RegionSettings& Instance();
+
+  /// Names of the regions that can be configured
+  static const std::vector<G4String>& RegionNames();
+
+  /// Create the region with the given root volumes and apply its production
+  /// cut (the default one if none is set) and step limits. A region placed
+  /// inside another one must be defined first, so that its volumes are not
+  /// included in the outer one.
+  void DefineRegion(const G4String& name,
+                    const std::vector<G4LogicalVolume*>& roots);
+
+  /// User limits of the volumes of a region that have a default
+  /// maximum step, with the values configured for the region on top
+  G4UserLimits* StepLimits(const G4String& name, G4double max_step = DBL_MAX) const;
+
+private:
+  RegionSettings();
+  ~RegionSettings();
+
+  /// Commands of one region, which act on the selected particle
+  class RegionMessenger
+  {
+  public:
+    RegionMessenger(RegionSettings* settings, const G4String& region);
+    ~RegionMessenger();
+  private:
+    void SetParticle(G4String particle);
+    void SetMaxStep(G4double max_step);
+
+    RegionSettings* settings_;
+    G4String region_;
+    G4String particle_;
+    G4double production_cut_;
+    G4GenericMessenger* msg_;
+
+    friend class RegionSettings;
+  };
+
+  /// Set the user limits of the volumes of the region without their own
+  void ApplyStepLimits(G4LogicalVolume* lv, G4UserLimits* limits) const;
+
+  std::vector<RegionMessenger*> messengers_;
+  /// Maximum step of each particle ("all" for the default) in each region
+  std::map<G4String, std::vector<std::pair<G4String, G4double>>> max_steps_;
+};
+
+#endif
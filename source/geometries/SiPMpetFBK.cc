@@ -37,7 +37,9 @@ SiPMpetFBK::SiPMpetFBK() : GeometryBase(),
                            sipm_size_(3. * mm),
                            sensor_depth_(-1),
                            mother_depth_(0),
-                           naming_order_(0)
+                           naming_order_(0),
+                           replica_depth_(0),
+                           mothers_per_replica_(0)
 
 {
   /// Messenger
@@ -138,6 +140,26 @@ void SiPMpetFBK::Construct()
 
   // SENSITIVE DETECTOR ////////////////////////////////////////////
 
+  AttachSensitiveDetector(active_logic);
+
+  // Visibilities
+  if (visibility_)
+  {
+    G4VisAttributes sipm_col = nexus::Yellow();
+    sipm_logic->SetVisAttributes(sipm_col);
+    G4VisAttributes active_col = nexus::Blue();
+    active_col.SetForceSolid(true);
+    active_logic->SetVisAttributes(active_col);
+  }
+  else
+  {
+    sipm_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+    active_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+  }
+}
+
+void SiPMpetFBK::AttachSensitiveDetector(G4LogicalVolume* active_logic)
+{
   G4String sdname = "/SIPM/SiPMpetFBK";
   G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
 
@@ -151,22 +173,8 @@ void SiPMpetFBK::Construct()
     sipmsd->SetDetectorVolumeDepth(sensor_depth_);
     sipmsd->SetMotherVolumeDepth(mother_depth_);
     sipmsd->SetDetectorNamingOrder(naming_order_);
+    sipmsd->SetReplicaVolumeDepth(replica_depth_, mothers_per_replica_);
     G4SDManager::GetSDMpointer()->AddNewDetector(sipmsd);
     active_logic->SetSensitiveDetector(sipmsd);
   }
-
-  // Visibilities
-  if (visibility_)
-  {
-    G4VisAttributes sipm_col = nexus::Yellow();
-    sipm_logic->SetVisAttributes(sipm_col);
-    G4VisAttributes active_col = nexus::Blue();
-    active_col.SetForceSolid(true);
-    active_logic->SetVisAttributes(active_col);
-  }
-  else
-  {
-    sipm_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
-    active_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
-  }
 }
@@ -13,6 +13,7 @@
 #include <G4ThreeVector.hh>
 
 class G4GenericMessenger;
+class G4LogicalVolume;
 
 using namespace nexus;
 
@@ -34,6 +35,12 @@ public:
   void SetSensorDepth(G4int sensor_depth);
   void SetMotherDepth(G4int mother_depth);
   void SetNamingOrder(G4int naming_order);
+  /// For mothers placed in replicas, see ToFSD::SetReplicaVolumeDepth
+  void SetReplicaDepth(G4int replica_depth, G4int mothers_per_replica);
+
+  /// Make the photodiodes sensitive, creating their sensitive
+  /// detector the first time
+  void AttachSensitiveDetector(G4LogicalVolume* active_logic);
 
 private:
   //G4ThreeVector _dimensions; ///< external dimensions of the SiPMpet
@@ -56,6 +63,8 @@ private:
   G4int sensor_depth_;
   G4int mother_depth_;
   G4int naming_order_;
+  G4int replica_depth_;
+  G4int mothers_per_replica_;
 };
 
 inline void SiPMpetFBK::SetSensorDepth(G4int sensor_depth)
@@ -73,4 +82,11 @@ inline void SiPMpetFBK::SetNamingOrder(G4int naming_order)
   naming_order_ = naming_order;
 }
 
+inline void SiPMpetFBK::SetReplicaDepth(G4int replica_depth,
+                                        G4int mothers_per_replica)
+{
+  replica_depth_ = replica_depth;
+  mothers_per_replica_ = mothers_per_replica;
+}
+
 #endif
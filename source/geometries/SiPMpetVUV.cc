@@ -11,6 +11,7 @@
 #include "ToFSD.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 
 #include "nexus/Visibilities.h"
 #include "nexus/MaterialsList.h"
@@ -77,7 +78,10 @@ void SiPMpetVUV::Construct()
   G4Material* window_mat = materials::FusedSilica();
   G4cout << "Quartz used with constant refraction index = "
          << refr_index_ << G4endl;
-  window_mat->SetMaterialPropertiesTable(petopticalprops::FakeGenericMaterial(refr_index_));
+  OpticalRegistry& optreg = OpticalRegistry::Instance();
+  window_mat->SetMaterialPropertiesTable(
+    optreg.Table("FakeGenericMaterial", petopticalprops::FakeGenericMaterial,
+                 refr_index_));
 
   this->SetLogicalVolume(sipm_logic);
 
@@ -119,34 +123,57 @@ void SiPMpetVUV::Construct()
 
   // SiPM efficiency set using the official Hamamatsu specs.
 
-  const G4int entries = 12;
-
-  G4double energies[entries] =
-    {1.5 * eV, 6.19919 * eV, 6.35814 * eV, 6.52546 * eV,
-     6.70182 * eV, 6.88799 * eV, 7.08479 * eV,
-     7.29316 * eV, 7.51417 * eV, 7.74898 * eV,
-     7.99895 * eV, 8.26558 * eV};
-  G4double reflectivity[entries] = {0., 0., 0., 0.,
-                                    0., 0., 0.,
-                                    0., 0., 0.,
-                                    0., 0.};
-  G4double efficiency[entries] = {eff_, eff_, eff_,
-                                  eff_, eff_, eff_,
-                                  eff_, eff_, eff_,
-                                  eff_, eff_};
-
-  G4MaterialPropertiesTable* sipm_mt = new G4MaterialPropertiesTable();
-  sipm_mt->AddProperty("EFFICIENCY", energies, efficiency, entries);
-  sipm_mt->AddProperty("REFLECTIVITY", energies, reflectivity, entries);
+  G4MaterialPropertiesTable* sipm_mt =
+    optreg.Table(OpticalRegistry::Key("SiPMpetVUV", {eff_}), [this] {
+      const G4int entries = 12;
+
+      G4double energies[entries] =
+        {1.5 * eV, 6.19919 * eV, 6.35814 * eV, 6.52546 * eV,
+         6.70182 * eV, 6.88799 * eV, 7.08479 * eV,
+         7.29316 * eV, 7.51417 * eV, 7.74898 * eV,
+         7.99895 * eV, 8.26558 * eV};
+      G4double reflectivity[entries] = {0., 0., 0., 0.,
+                                        0., 0., 0.,
+                                        0., 0., 0.,
+                                        0., 0.};
+      G4double efficiency[entries] = {eff_, eff_, eff_,
+                                      eff_, eff_, eff_,
+                                      eff_, eff_, eff_,
+                                      eff_, eff_};
+
+      auto mt = new G4MaterialPropertiesTable();
+      mt->AddProperty("EFFICIENCY", energies, efficiency, entries);
+      mt->AddProperty("REFLECTIVITY", energies, reflectivity, entries);
+      return mt;
+    });
 
   G4OpticalSurface* sipm_opsurf =
-      new G4OpticalSurface("SIPM_OPSURF", unified, polished, dielectric_metal);
-  sipm_opsurf->SetMaterialPropertiesTable(sipm_mt);
+    optreg.Surface("SIPM_OPSURF", unified, polished, dielectric_metal, sipm_mt);
 
   new G4LogicalSkinSurface("SIPM_OPSURF", active_logic, sipm_opsurf);
 
   // SENSITIVE DETECTOR ////////////////////////////////////////////
 
+  AttachSensitiveDetector(active_logic);
+
+  // Visibilities
+  if (visibility_)
+  {
+    G4VisAttributes sipm_col = nexus::Yellow();
+    sipm_logic->SetVisAttributes(sipm_col);
+    G4VisAttributes active_col = nexus::Blue();
+    active_col.SetForceSolid(true);
+    active_logic->SetVisAttributes(active_col);
+  }
+  else
+  {
+    sipm_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+    active_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+  }
+}
+
+void SiPMpetVUV::AttachSensitiveDetector(G4LogicalVolume* active_logic)
+{
   G4String sdname = "/SIPM/SiPMpetVUV";
   G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
 
@@ -163,19 +190,4 @@ void SiPMpetVUV::Construct()
     G4SDManager::GetSDMpointer()->AddNewDetector(sipmsd);
     active_logic->SetSensitiveDetector(sipmsd);
   }
-
-  // Visibilities
-  if (visibility_)
-  {
-    G4VisAttributes sipm_col = nexus::Yellow();
-    sipm_logic->SetVisAttributes(sipm_col);
-    G4VisAttributes active_col = nexus::Blue();
-    active_col.SetForceSolid(true);
-    active_logic->SetVisAttributes(active_col);
-  }
-  else
-  {
-    sipm_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
-    active_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
-  }
 }
@@ -14,6 +14,7 @@
 #include <G4ThreeVector.hh>
 
 class G4GenericMessenger;
+class G4LogicalVolume;
 
 using namespace nexus;
 /// Geometry of the Hamamatsu surface-mounted 1x1 mm2 MPPC (SiPM)
@@ -33,6 +34,10 @@ public:
   void SetMotherDepth(G4int mother_depth);
   void SetNamingOrder(G4int naming_order);
 
+  /// Make the photodiodes sensitive, creating their sensitive
+  /// detector the first time
+  void AttachSensitiveDetector(G4LogicalVolume* active_logic);
+
 private:
   // Visibility of the tracking plane
   G4bool visibility_;
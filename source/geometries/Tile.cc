@@ -8,6 +8,7 @@
 
 #include "Tile.h"
 #include "SiPMpetFBK.h"
+#include "OverlapCheck.h"
 
 #include "nexus/Visibilities.h"
 #include "nexus/MaterialsList.h"
@@ -35,7 +36,9 @@ Tile::Tile() : GeometryBase(),
                tile_z_(3. * mm),
                sipm_pitch_(4.7 * mm),
                n_rows_(8),
-               n_columns_(4)
+               n_columns_(4),
+               replica_depth_(0),
+               tiles_per_replica_(0)
 
 {
   /// Messenger
@@ -70,6 +73,9 @@ Tile::Tile() : GeometryBase(),
   msg_->DeclareProperty("columns", n_columns_, "Number of columns");
 
   sipm_ = new SiPMpetFBK();
+
+  // Its commands must exist before the configuration macros are executed
+  OverlapCheck::Instance();
 }
 
 Tile::~Tile()
@@ -90,9 +96,9 @@ void Tile::Construct()
 
   this->SetLogicalVolume(tile_logic);
 
-  sipm_->SetSensorDepth(1);
-  sipm_->SetMotherDepth(3);
-  sipm_->SetNamingOrder(1000);
+  G4bool check_overlaps = OverlapCheck::Instance().IsEnabled();
+
+  SetSensorNumbering();
   sipm_->Construct();
   G4ThreeVector sipm_dim = sipm_->GetDimensions();
 
@@ -110,7 +116,7 @@ void Tile::Construct()
       new G4LogicalVolume(air_solid, air, "TILE_AIR");
 
   new G4PVPlacement(0, G4ThreeVector(0., 0., tile_z_ / 2. - air_z / 2.),
-                    air_logic, "TILE_AIR", tile_logic, false, 0, true);
+                    air_logic, "TILE_AIR", tile_logic, false, 0, check_overlaps);
 
   G4LogicalVolume *sipm_logic = sipm_->GetLogicalVolume();
   //G4double support_thickness = 1. * mm;
@@ -122,7 +128,7 @@ void Tile::Construct()
     {
       count += 1;
       new G4PVPlacement(0, G4ThreeVector(-tile_x_ / 2. + offset_x + sipm_dim.x() / 2. + i * sipm_pitch_, -tile_y_ / 2. + offset_y + sipm_dim.y() / 2. + j * sipm_pitch_, tile_z_ / 2. - air_z + sipm_dim.z() / 2.),
-                        sipm_logic, "SiPMpetFBK", air_logic, false, count, true);
+                        sipm_logic, "SiPMpetFBK", air_logic, false, count, check_overlaps);
     }
   }
 
@@ -138,7 +144,7 @@ void Tile::Construct()
       new G4LogicalVolume(quartz_solid, quartz, "TILE_WINDOW");
 
   new G4PVPlacement(0, G4ThreeVector(0., 0., air_z / 2. - quartz_z / 2.),
-                    quartz_logic, "TILE_WINDOW", air_logic, false, 0, true);
+                    quartz_logic, "TILE_WINDOW", air_logic, false, 0, check_overlaps);
 
   // Visibilities
   if (visibility_)
@@ -163,3 +169,17 @@ G4ThreeVector Tile::GetDimensions()
 
   return G4ThreeVector(tile_x_, tile_y_, tile_z_);
 }
+
+void Tile::SetSensorNumbering()
+{
+  sipm_->SetSensorDepth(1);
+  sipm_->SetMotherDepth(3);
+  sipm_->SetNamingOrder(1000);
+  sipm_->SetReplicaDepth(3 + replica_depth_, tiles_per_replica_);
+}
+
+void Tile::AttachSensitiveDetector(G4LogicalVolume* photodiodes_logic)
+{
+  SetSensorNumbering();
+  sipm_->AttachSensitiveDetector(photodiodes_logic);
+}
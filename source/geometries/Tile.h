@@ -13,6 +13,7 @@
 #include <G4ThreeVector.hh>
 
 class G4GenericMessenger;
+class G4LogicalVolume;
 class SiPMpetFBK;
 
 using namespace nexus;
@@ -30,7 +31,17 @@ using namespace nexus;
 
     G4ThreeVector GetDimensions();
 
+    /// To be used when the tiles are placed in replicated volumes: depth of
+    /// the replica relative to the tile, and number of tiles in each copy
+    void SetReplicaDepth(G4int replica_depth, G4int tiles_per_replica);
+
+    /// Make the photodiodes of the SiPMs sensitive, for tiles
+    /// read from a cached geometry instead of constructed
+    void AttachSensitiveDetector(G4LogicalVolume* photodiodes_logic);
+
   private:
+    /// Depths and numbering used to compute the IDs of the SiPMs
+    void SetSensorNumbering();
 
     // Visibility of the tracking plane
     G4bool visibility_;
@@ -49,6 +60,15 @@ using namespace nexus;
 
     SiPMpetFBK* sipm_;
 
+    G4int replica_depth_;
+    G4int tiles_per_replica_;
+
   };
 
+  inline void Tile::SetReplicaDepth(G4int replica_depth, G4int tiles_per_replica)
+  {
+    replica_depth_ = replica_depth;
+    tiles_per_replica_ = tiles_per_replica;
+  }
+
 #endif
@@ -9,6 +9,7 @@
 #include "TileHamamatsuBlue.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "SiPMHamamatsuBlue.h"
 
 #include "nexus/Visibilities.h"
@@ -62,9 +63,12 @@ void TileHamamatsuBlue::Construct()
   this->SetLogicalVolume(tile_logic);
 
   // OPTICAL SURFACE FOR REFLECTION
-  G4OpticalSurface *fr4_opsurf =
-      new G4OpticalSurface("FR4_OPSURF", unified, polished, dielectric_metal);
-  fr4_opsurf->SetMaterialPropertiesTable(petopticalprops::ReflectantSurface(GetTileReflectivity()));
+  OpticalRegistry& optreg = OpticalRegistry::Instance();
+  G4MaterialPropertiesTable* fr4_mpt =
+    optreg.Table("ReflectantSurface", petopticalprops::ReflectantSurface,
+                 GetTileReflectivity());
+  G4OpticalSurface* fr4_opsurf =
+    optreg.Surface("FR4_OPSURF", unified, polished, dielectric_metal, fr4_mpt);
 
   new G4LogicalSkinSurface("FR4_OPSURF", tile_logic, fr4_opsurf);
 
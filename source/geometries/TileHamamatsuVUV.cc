@@ -9,6 +9,7 @@
 #include "TileHamamatsuVUV.h"
 #include "PetMaterialsList.h"
 #include "PetOpticalMaterialProperties.h"
+#include "OpticalRegistry.h"
 #include "SiPMHamamatsuVUV.h"
 #include "SiPMCells.h"
 #include "MicroCellHmtsuVUV.h"
@@ -64,9 +65,12 @@ void TileHamamatsuVUV::Construct()
   this->SetLogicalVolume(tile_logic);
 
   // OPTICAL SURFACE FOR REFLECTION
+  OpticalRegistry& optreg = OpticalRegistry::Instance();
+  G4MaterialPropertiesTable* fr4_mpt =
+    optreg.Table("ReflectantSurface", petopticalprops::ReflectantSurface,
+                 GetTileReflectivity());
   G4OpticalSurface* fr4_opsurf =
-      new G4OpticalSurface("FR4_OPSURF", unified, polished, dielectric_metal);
-  fr4_opsurf->SetMaterialPropertiesTable(petopticalprops::ReflectantSurface(GetTileReflectivity()));
+    optreg.Surface("FR4_OPSURF", unified, polished, dielectric_metal, fr4_mpt);
 
   new G4LogicalSkinSurface("FR4_OPSURF", tile_logic, fr4_opsurf);
 
@@ -119,7 +123,9 @@ void TileHamamatsuVUV::Construct()
     new G4Box("TILE_QUARTZ_WINDOW", quartz_x/2., quartz_y/2., quartz_thick_/2);
 
   G4Material *quartz = materials::FusedSilica();
-  quartz->SetMaterialPropertiesTable(petopticalprops::FakeGenericMaterial(quartz_rindex_));
+  quartz->SetMaterialPropertiesTable(
+    optreg.Table("FakeGenericMaterial", petopticalprops::FakeGenericMaterial,
+                 quartz_rindex_));
 
   G4LogicalVolume* quartz_logic =
       new G4LogicalVolume(quartz_solid, quartz, "TILE_QUARTZ_WINDOW");
@@ -0,0 +1,184 @@
+// ----------------------------------------------------------------------------
+// petalosim | VoxelPhantom.cc
+//
+// This class implements a voxelized phantom read from two raw images of
+// the same size: one with the index of the material of each voxel
+// (1 byte per voxel) and one with the activity (1 float per voxel),
+// both with x running fastest and z slowest. The voxels are built with
+// a G4PhantomParameterisation and navigated with G4RegularNavigation.
+// The vertices are generated following the activity image.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "VoxelPhantom.h"
+#include "VoxelPointSampler.h"
+#include "InitProfiler.h"
+
+#include "nexus/FactoryBase.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4Box.hh>
+#include <G4LogicalVolume.hh>
+#include <G4PVParameterised.hh>
+#include <G4PhantomParameterisation.hh>
+#include <G4NistManager.hh>
+#include <G4Material.hh>
+#include <G4VisAttributes.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+using namespace nexus;
+
+REGISTER_CLASS(VoxelPhantom, GeometryBase)
+
+VoxelPhantom::VoxelPhantom(): GeometryBase(),
+                              material_file_(""),
+                              activity_file_(""),
+                              n_x_(0), n_y_(0), n_z_(0),
+                              voxel_size_(1.*mm, 1.*mm, 1.*mm),
+                              activity_gen_(nullptr)
+{
+  msg_ = new G4GenericMessenger(this, "/Geometry/VoxelPhantom/",
+                                "Control commands of geometry VoxelPhantom.");
+  msg_->DeclareProperty("material_file", material_file_,
+                        "Raw image with the material index of each voxel.");
+  msg_->DeclareProperty("activity_file", activity_file_,
+                        "Raw image with the activity of each voxel.");
+  msg_->DeclareProperty("n_voxels_x", n_x_, "Number of voxels along x.");
+  msg_->DeclareProperty("n_voxels_y", n_y_, "Number of voxels along y.");
+  msg_->DeclareProperty("n_voxels_z", n_z_, "Number of voxels along z.");
+  msg_->DeclarePropertyWithUnit("voxel_size", "mm", voxel_size_,
+                                "Dimensions of a voxel.");
+  msg_->DeclareMethod("add_material", &VoxelPhantom::AddMaterial,
+                      "NIST name of the material of the next index of the image.");
+}
+
+
+VoxelPhantom::~VoxelPhantom()
+{
+  delete activity_gen_;
+  delete msg_;
+}
+
+
+void VoxelPhantom::AddMaterial(G4String name)
+{
+  material_names_.push_back(name);
+}
+
+
+void VoxelPhantom::Construct()
+{
+  InitProfiler::Scope profile("VoxelPhantom::Construct");
+
+  if (n_x_ <= 0 || n_y_ <= 0 || n_z_ <= 0) {
+    G4Exception("[VoxelPhantom]", "Construct()", FatalException,
+                "The number of voxels must be positive.");
+  }
+
+  if (material_names_.empty()) {
+    material_names_ = {"G4_AIR", "G4_WATER"};
+  }
+
+  std::vector<G4Material*> materials;
+  for (const auto& name : material_names_) {
+    G4Material* mat = G4NistManager::Instance()->FindOrBuildMaterial(name);
+    if (!mat) {
+      G4Exception("[VoxelPhantom]", "Construct()", FatalException,
+                  ("Unknown material " + name).c_str());
+    }
+    materials.push_back(mat);
+  }
+
+  ReadMaterialImage();
+  for (auto index : material_indices_) {
+    if (index >= materials.size()) {
+      G4Exception("[VoxelPhantom]", "Construct()", FatalException,
+                  "The material image has more indices than materials.");
+    }
+  }
+
+  ReadActivityImage();
+
+  G4ThreeVector dim = GetDimensions();
+  auto container_solid =
+    new G4Box("VOXEL_PHANTOM", dim.x()/2., dim.y()/2., dim.z()/2.);
+  auto container_logic =
+    new G4LogicalVolume(container_solid, materials[0], "VOXEL_PHANTOM");
+  container_logic->SetVisAttributes(G4VisAttributes::GetInvisible());
+  this->SetLogicalVolume(container_logic);
+
+  auto voxel_solid = new G4Box("VOXEL", voxel_size_.x()/2., voxel_size_.y()/2.,
+                               voxel_size_.z()/2.);
+  auto voxel_logic = new G4LogicalVolume(voxel_solid, materials[0], "VOXEL");
+
+  auto param = new G4PhantomParameterisation();
+  param->SetVoxelDimensions(voxel_size_.x()/2., voxel_size_.y()/2.,
+                            voxel_size_.z()/2.);
+  param->SetNoVoxels(n_x_, n_y_, n_z_);
+  param->SetMaterials(materials);
+  param->SetMaterialIndices(material_indices_.data());
+  param->BuildContainerSolid(container_solid);
+  param->CheckVoxelsFillContainer(container_solid->GetXHalfLength(),
+                                  container_solid->GetYHalfLength(),
+                                  container_solid->GetZHalfLength());
+
+  // A regular structure id makes Geant4 use G4RegularNavigation,
+  // which skips the boundaries between voxels of equal material
+  auto voxel_phys =
+    new G4PVParameterised("VOXEL", voxel_logic, container_logic, kUndefined,
+                          n_x_ * n_y_ * n_z_, param);
+  voxel_phys->SetRegularStructureId(1);
+}
+
+
+void VoxelPhantom::ReadMaterialImage()
+{
+  std::ifstream is(material_file_, std::ifstream::binary);
+  std::vector<unsigned char> image(std::size_t(n_x_) * n_y_ * n_z_);
+  is.read(reinterpret_cast<char*>(image.data()), image.size());
+
+  if (!is) {
+    G4Exception("[VoxelPhantom]", "ReadMaterialImage()", FatalErrorInArgument,
+                ("Cannot read the material image " + material_file_).c_str());
+  }
+
+  material_indices_.assign(image.begin(), image.end());
+}
+
+
+void VoxelPhantom::ReadActivityImage()
+{
+  // The image is read one z slice at a time and stored with z
+  // running fastest, which is the order of VoxelPointSampler
+  std::ifstream is(activity_file_, std::ifstream::binary);
+  std::size_t slice_size = std::size_t(n_x_) * n_y_;
+  std::vector<float> slice(slice_size);
+  std::vector<G4float> weights(slice_size * n_z_);
+
+  for (G4int k=0; k<n_z_ && is; ++k) {
+    is.read(reinterpret_cast<char*>(slice.data()), slice_size * sizeof(float));
+    for (G4int j=0; j<n_y_; ++j)
+      for (G4int i=0; i<n_x_; ++i)
+        weights[(std::size_t(i) * n_y_ + j) * n_z_ + k] =
+          std::max(slice[j * n_x_ + i], 0.f);
+  }
+
+  if (!is) {
+    G4Exception("[VoxelPhantom]", "ReadActivityImage()", FatalErrorInArgument,
+                ("Cannot read the activity image " + activity_file_).c_str());
+  }
+
+  delete activity_gen_;
+  activity_gen_ = new VoxelPointSampler(n_x_, n_y_, n_z_, GetDimensions(),
+                                        std::move(weights));
+}
+
+
+G4ThreeVector VoxelPhantom::GenerateVertex(const G4String& /*region*/) const
+{
+  return activity_gen_->GenerateVertex();
+}
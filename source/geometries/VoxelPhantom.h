@@ -0,0 +1,65 @@
+// ----------------------------------------------------------------------------
+// petalosim | VoxelPhantom.h
+//
+// This class implements a voxelized phantom read from two raw images of
+// the same size: one with the index of the material of each voxel
+// (1 byte per voxel) and one with the activity (1 float per voxel),
+// both with x running fastest and z slowest. The voxels are built with
+// a G4PhantomParameterisation and navigated with G4RegularNavigation.
+// The vertices are generated following the activity image.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef VOXEL_PHANTOM_H
+#define VOXEL_PHANTOM_H
+
+#include "nexus/GeometryBase.h"
+
+#include <vector>
+
+class G4GenericMessenger;
+class VoxelPointSampler;
+
+using namespace nexus;
+
+class VoxelPhantom: public GeometryBase
+{
+public:
+  VoxelPhantom();
+  ~VoxelPhantom();
+
+  void Construct();
+
+  G4ThreeVector GenerateVertex(const G4String& region) const;
+
+  /// Dimensions of the whole phantom
+  G4ThreeVector GetDimensions() const;
+
+private:
+  /// Add a material for the next index of the material image
+  void AddMaterial(G4String name);
+  void ReadMaterialImage();
+  void ReadActivityImage();
+
+  G4GenericMessenger* msg_;
+
+  G4String material_file_;
+  G4String activity_file_;
+  G4int n_x_, n_y_, n_z_;
+  G4ThreeVector voxel_size_;
+  std::vector<G4String> material_names_;
+
+  /// Material index of each voxel, which must live as long as the geometry
+  std::vector<std::size_t> material_indices_;
+
+  VoxelPointSampler* activity_gen_;
+};
+
+inline G4ThreeVector VoxelPhantom::GetDimensions() const
+{
+  return G4ThreeVector(n_x_ * voxel_size_.x(), n_y_ * voxel_size_.y(),
+                       n_z_ * voxel_size_.z());
+}
+
+#endif
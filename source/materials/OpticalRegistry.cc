@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// petalosim | OpticalRegistry.cc
+//
+// This class hands out optical property tables and optical surfaces shared
+// by all the geometries. A table is identified by the name of its builder
+// and its parameters and is built only the first time it is requested;
+// a surface is identified by its name, type, model, finish, roughness and
+// table. Geometries with many surfaces of the same kind thus use a single
+// copy of the optical data. It is only used while the geometries are built,
+// on the master thread, so it takes no lock.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalRegistry.h"
+
+#include <G4MaterialPropertiesTable.hh>
+
+#include <sstream>
+
+
+OpticalRegistry& OpticalRegistry::Instance()
+{
+  static OpticalRegistry instance;
+  return instance;
+}
+
+
+OpticalRegistry::OpticalRegistry()
+{
+}
+
+
+OpticalRegistry::~OpticalRegistry()
+{
+}
+
+
+G4String OpticalRegistry::Key(const G4String& builder,
+                              std::initializer_list<G4double> params)
+{
+  // Parameters are written with full precision,
+  // so that different values never share a key
+  std::ostringstream key;
+  key.precision(17);
+  key << builder;
+  for (auto p : params) key << "_" << p;
+  return key.str();
+}
+
+
+G4MaterialPropertiesTable* OpticalRegistry::Table(const G4String& key,
+  const std::function<G4MaterialPropertiesTable*()>& build)
+{
+  auto it = tables_.find(key);
+  if (it != tables_.end()) return it->second;
+
+  G4MaterialPropertiesTable* mpt = build();
+  tables_[key] = mpt;
+  return mpt;
+}
+
+
+G4OpticalSurface* OpticalRegistry::Surface(const G4String& name,
+                                           G4OpticalSurfaceModel model,
+                                           G4OpticalSurfaceFinish finish,
+                                           G4SurfaceType type,
+                                           G4MaterialPropertiesTable* mpt,
+                                           G4double sigma_alpha)
+{
+  std::ostringstream key;
+  key.precision(17);
+  key << name << "_" << model << "_" << finish << "_" << type << "_"
+      << sigma_alpha << "_" << mpt;
+
+  auto it = surfaces_.find(key.str());
+  if (it != surfaces_.end()) return it->second;
+
+  G4OpticalSurface* surface =
+    new G4OpticalSurface(name, model, finish, type, sigma_alpha);
+  surface->SetMaterialPropertiesTable(mpt);
+  surfaces_[key.str()] = surface;
+  return surface;
+}
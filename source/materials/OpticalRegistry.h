@@ -0,0 +1,71 @@
+// ----------------------------------------------------------------------------
+// petalosim | OpticalRegistry.h
+//
+// This class hands out optical property tables and optical surfaces shared
+// by all the geometries. A table is identified by the name of its builder
+// and its parameters and is built only the first time it is requested;
+// a surface is identified by its name, type, model, finish, roughness and
+// table. Geometries with many surfaces of the same kind thus use a single
+// copy of the optical data. It is only used while the geometries are built,
+// on the master thread, so it takes no lock.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_REGISTRY_H
+#define OPTICAL_REGISTRY_H
+
+#include <globals.hh>
+#include <G4OpticalSurface.hh>
+
+#include <functional>
+#include <initializer_list>
+#include <map>
+
+class G4MaterialPropertiesTable;
+
+class OpticalRegistry
+{
+public:
+  static OpticalRegistry& Instance();
+
+  /// Key of a table built by the given builder with the given parameters
+  static G4String Key(const G4String& builder,
+                      std::initializer_list<G4double> params = {});
+
+  /// Table with the given key, built by the given function if it
+  /// has not been requested before
+  G4MaterialPropertiesTable* Table(const G4String& key,
+    const std::function<G4MaterialPropertiesTable*()>& build);
+
+  /// Table returned by a builder of petopticalprops or opticalprops
+  /// with numerical parameters
+  template <typename... Params, typename... Args>
+  G4MaterialPropertiesTable* Table(const G4String& builder,
+    G4MaterialPropertiesTable* (*build)(Params...), Args... args);
+
+  /// Optical surface with the given properties and table
+  G4OpticalSurface* Surface(const G4String& name, G4OpticalSurfaceModel model,
+                            G4OpticalSurfaceFinish finish, G4SurfaceType type,
+                            G4MaterialPropertiesTable* mpt,
+                            G4double sigma_alpha = 0.);
+
+private:
+  OpticalRegistry();
+  ~OpticalRegistry();
+
+  std::map<G4String, G4MaterialPropertiesTable*> tables_;
+  std::map<G4String, G4OpticalSurface*> surfaces_;
+};
+
+template <typename... Params, typename... Args>
+inline G4MaterialPropertiesTable*
+OpticalRegistry::Table(const G4String& builder,
+                       G4MaterialPropertiesTable* (*build)(Params...),
+                       Args... args)
+{
+  return Table(Key(builder, {G4double(args)...}),
+               [=] { return build(args...); });
+}
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "PetOpticalMaterialProperties.h"
 #include "PetXenonProperties.h"
+#include "InitProfiler.h"
 
 #include "nexus/XenonProperties.h"
 #include "nexus/SellmeierEquation.h"
@@ -24,6 +25,8 @@ namespace petopticalprops {
 
 G4MaterialPropertiesTable* Epoxy()
 {
+  InitProfiler::Scope profile("petopticalprops::Epoxy");
+
   // Optical properties of Epoxy adhesives.
   // Obtained from
   // http://www.epotek.com/SSCDocs/techtips/Tech%20Tip%2018%20-%20Understanding%20Optical%20Properties%20for%20Epoxy%20Apps.pdf
@@ -53,6 +56,8 @@ G4MaterialPropertiesTable* Epoxy()
 
 G4MaterialPropertiesTable* EpoxyFixedRefr(G4double n)
 {
+  InitProfiler::Scope profile("petopticalprops::EpoxyFixedRefr");
+
   // Costum refractive index.
 
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
@@ -76,6 +81,8 @@ G4MaterialPropertiesTable* EpoxyFixedRefr(G4double n)
 
 G4MaterialPropertiesTable* EpoxyLXeRefr()
 {
+  InitProfiler::Scope profile("petopticalprops::EpoxyLXeRefr");
+
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
   const G4int ri_entries = 200;
@@ -108,6 +115,8 @@ G4MaterialPropertiesTable* EpoxyLXeRefr()
 
 G4MaterialPropertiesTable* FakeGenericMaterial(G4double quartz_rindex)
 {
+  InitProfiler::Scope profile("petopticalprops::FakeGenericMaterial");
+
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
   std::vector<G4double> energy =
@@ -128,6 +137,8 @@ G4MaterialPropertiesTable* FakeGenericMaterial(G4double quartz_rindex)
 
 G4MaterialPropertiesTable* GlassEpoxy()
 {
+  InitProfiler::Scope profile("petopticalprops::GlassEpoxy");
+
  // WARNING: This is a deprecated optical property, it is kept for code consistency, but it
  // will be removed in the future.
  // Optical properties of Optorez 1330 glass epoxy.
@@ -174,6 +185,8 @@ G4MaterialPropertiesTable* GlassEpoxy()
 
   G4MaterialPropertiesTable* LXe(G4double pressure)
   {
+    InitProfiler::Scope profile("petopticalprops::LXe");
+
     /// The time constants are taken from E. Hogenbirk et al 2018 JINST 13 P10031
     G4MaterialPropertiesTable* LXe_mpt = new G4MaterialPropertiesTable();
 
@@ -251,6 +264,8 @@ G4MaterialPropertiesTable* GlassEpoxy()
 
 G4MaterialPropertiesTable* LXe_nconst()
 {
+  InitProfiler::Scope profile("petopticalprops::LXe_nconst");
+
   G4MaterialPropertiesTable* LXe_mpt = new G4MaterialPropertiesTable();
 
   std::vector<G4double> ri_energy =
@@ -304,6 +319,8 @@ G4MaterialPropertiesTable* LXe_nconst()
 
 G4MaterialPropertiesTable* Pyrex_vidrasa()
 {
+  InitProfiler::Scope profile("petopticalprops::Pyrex_vidrasa");
+
   G4MaterialPropertiesTable* pyrex_mpt = new G4MaterialPropertiesTable();
 
   // Refractive index and absorption lenth taken from:
@@ -338,6 +355,8 @@ G4MaterialPropertiesTable* Pyrex_vidrasa()
 /// PTFE (== TEFLON) ///
 G4MaterialPropertiesTable* PTFE()
 {
+  InitProfiler::Scope profile("petopticalprops::PTFE");
+
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
   // REFLECTIVITY IN LXE
@@ -369,6 +388,7 @@ G4MaterialPropertiesTable* PTFE()
 
 G4MaterialPropertiesTable* TPB(G4double decay_time)
 {
+  InitProfiler::Scope profile("petopticalprops::TPB");
 
   /// This is the simulation of the optical properties of TPB (tetraphenyl butadiene)
   /// a wavelength shifter which allows to converts VUV photons to blue photons.
@@ -464,6 +484,8 @@ G4MaterialPropertiesTable* TPB(G4double decay_time)
 
 G4MaterialPropertiesTable* TPB_LXe(G4double decay_time)
 {
+  InitProfiler::Scope profile("petopticalprops::TPB_LXe");
+
   /// This is the simulation of the optical properties of TPB
   /// (tetraphenyl butadiene), a wavelength shifter which allows one
   /// to convert VUV photons to blue photons.
@@ -573,6 +595,8 @@ G4MaterialPropertiesTable* TPB_LXe(G4double decay_time)
 
 G4MaterialPropertiesTable* TPB_LXe_nconst(G4double decay_time)
 {
+  InitProfiler::Scope profile("petopticalprops::TPB_LXe_nconst");
+
   /// This is the simulation of the optical properties of TPB
   /// (tetraphenyl butadiene), a wavelength shifter which allows one
   /// to convert VUV photons to blue photons.
@@ -670,6 +694,8 @@ G4MaterialPropertiesTable* TPB_LXe_nconst(G4double decay_time)
 
 G4MaterialPropertiesTable* LYSO()
 {
+  InitProfiler::Scope profile("petopticalprops::LYSO");
+
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
   G4double const lyso_minE = 1.9630 * eV; // this value should be changed to the lower limit of detection of the specific photosensor used
@@ -763,6 +789,8 @@ G4MaterialPropertiesTable* LYSO()
 
 G4MaterialPropertiesTable* LYSO_nconst()
 {
+  InitProfiler::Scope profile("petopticalprops::LYSO_nconst");
+
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
   G4double const lyso_minE = 1.9630 * eV; // this value should be changed to the lower limit of detection of the specific photosensor used
@@ -843,6 +871,8 @@ G4MaterialPropertiesTable* LYSO_nconst()
 
 G4MaterialPropertiesTable* ReflectantSurface(G4double reflectivity)
 {
+  InitProfiler::Scope profile("petopticalprops::ReflectantSurface");
+
   G4MaterialPropertiesTable* mpt = new G4MaterialPropertiesTable();
 
   std::vector<G4double> ENERGIES =
@@ -7,8 +7,10 @@
 // ----------------------------------------------------------------------------
 
 #include "PetXenonProperties.h"
+#include "InitProfiler.h"
 
 #include <G4SystemOfUnits.hh>
+#include <algorithm>
 #include <fstream>
 
 
@@ -53,38 +55,65 @@
 }
 
 
+namespace {
+
+  /// Pressures and densities of the saturation curve, ordered in pressure
+  struct LXeDensityTable {
+    std::vector<G4double> pressure;
+    std::vector<G4double> density;
+  };
+
+  const LXeDensityTable& GetLXeDensityTable()
+  {
+    // The file is read only once per process,
+    // the initialization of a static being thread safe
+    static const LXeDensityTable table = [] {
+      std::vector<std::vector<G4double>> data;
+      MakeLXeDensityDataTable(data);
+      LXeDensityTable t;
+      for (const auto& row : data) {
+        t.pressure.push_back(row[1]);
+        t.density.push_back(row[2]);
+      }
+      return t;
+    }();
+    return table;
+  }
+
+}
+
+
 G4double GetLXeDensity(G4double pressure)
 {
+  InitProfiler::Scope profile("GetLXeDensity");
+
   // Interpolate to calculate the density at a given pressure.
   // The temperature is unique, given the pressure, and it follows the liquid-vapor
   // saturation curve of liquid xenon.
-  G4double density = 5.324 * kg/m3;
-  std::vector<std::vector<G4double>> data;
-  G4int n_keys = MakeLXeDensityDataTable(data);
-
-  // Use linear interpolation
-  G4bool found = false;
-
-  for (G4int i=0; i<n_keys-1; ++i) {
-    if (pressure >= data[i][1] && pressure < data[i+1][1]) {
-      G4double x1 = data[i][1];
-      G4double x2 = data[i+1][1];
-      G4double y1 = data[i][2];
-      G4double y2 = data[i+1][2];
-      density = y1 + (y2-y1)*(pressure-x1)/(x2-x1);
-      found = true;
-      break;
-    }
+  const LXeDensityTable& table = GetLXeDensityTable();
+  const std::vector<G4double>& p = table.pressure;
+  const std::vector<G4double>& d = table.density;
+
+  if (p.empty()) {
+    throw "Unknown xenon density for this pressure!";
   }
 
-  if (!found) {
-    if (pressure == data[n_keys-1][1]) {
-      density = data[n_keys-1][2];
-    }
-    else {
-      throw "Unknown xenon density for this pressure!";
-    }
+  if (pressure == p.back()) {
+    return d.back();
   }
 
-  return density;
+  // Use linear interpolation between the first pressure above
+  // the given one and the previous one
+  auto it = std::upper_bound(p.begin(), p.end(), pressure);
+  if (it == p.begin() || it == p.end()) {
+    throw "Unknown xenon density for this pressure!";
+  }
+
+  std::size_t i = it - p.begin() - 1;
+  G4double x1 = p[i];
+  G4double x2 = p[i+1];
+  G4double y1 = d[i];
+  G4double y2 = d[i+1];
+
+  return y1 + (y2-y1)*(pressure-x1)/(x2-x1);
 }
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------
+// petalosim | EventRowBuffer.h
+//
+// This class holds the rows of the event tables (sensor response,
+// hits, particles, charge and steps), either of one event while it
+// is stored or of the events staged by the HDF5Writer.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef EVENT_ROW_BUFFER_H
+#define EVENT_ROW_BUFFER_H
+
+#include "hdf5_functions.h"
+
+#include <vector>
+
+class EventRowBuffer
+{
+public:
+  /// Remove all the rows, keeping the allocated memory
+  void Clear();
+  /// Total number of rows
+  size_t Size() const;
+  /// Total size of the rows in bytes
+  size_t Bytes() const;
+  /// Append the rows of another buffer after the current ones
+  void Append(const EventRowBuffer& rows);
+
+  std::vector<sns_data_t>      sns_data;
+  std::vector<sns_tof_t>       sns_tof;
+  std::vector<hit_info_t>      hits;
+  std::vector<particle_info_t> particles;
+  std::vector<charge_data_t>   charge;
+  std::vector<step_info_t>     steps;
+};
+
+// INLINE DEFINITIONS //////////////////////////////////////////////
+
+inline void EventRowBuffer::Clear()
+{
+  sns_data.clear();
+  sns_tof.clear();
+  hits.clear();
+  particles.clear();
+  charge.clear();
+  steps.clear();
+}
+inline size_t EventRowBuffer::Size() const
+{
+  return sns_data.size() + sns_tof.size() + hits.size() + particles.size() +
+    charge.size() + steps.size();
+}
+inline size_t EventRowBuffer::Bytes() const
+{
+  return sns_data.size()  * sizeof(sns_data_t)
+       + sns_tof.size()   * sizeof(sns_tof_t)
+       + hits.size()      * sizeof(hit_info_t)
+       + particles.size() * sizeof(particle_info_t)
+       + charge.size()    * sizeof(charge_data_t)
+       + steps.size()     * sizeof(step_info_t);
+}
+inline void EventRowBuffer::Append(const EventRowBuffer& rows)
+{
+  sns_data.insert(sns_data.end(), rows.sns_data.begin(), rows.sns_data.end());
+  sns_tof.insert(sns_tof.end(), rows.sns_tof.begin(), rows.sns_tof.end());
+  hits.insert(hits.end(), rows.hits.begin(), rows.hits.end());
+  particles.insert(particles.end(), rows.particles.begin(), rows.particles.end());
+  charge.insert(charge.end(), rows.charge.begin(), rows.charge.end());
+  steps.insert(steps.end(), rows.steps.begin(), rows.steps.end());
+}
+
+#endif
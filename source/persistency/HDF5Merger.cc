@@ -0,0 +1,275 @@
+// ----------------------------------------------------------------------------
+// petalosim | HDF5Merger.cc
+//
+// This class merges several petalosim output files, written by
+// the processes of the same job, into a single file.
+// The event tables are merged in event order, sensor positions
+// are written once and the event counters of the configuration
+// table are added up. The tables are copied in blocks of a fixed
+// number of rows, so the memory used does not grow with the files.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "HDF5Merger.h"
+#include "hdf5_functions.h"
+
+#include <G4Exception.hh>
+#include <globals.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+
+
+namespace {
+
+  /// Keys of the configuration table that count events or photons
+  /// and must be added up over the merged files
+  bool IsCounter(const std::string& key)
+  {
+    return key == "num_events" || key == "saved_events" ||
+      key == "interacting_events" || key.rfind("photon_sink_", 0) == 0;
+  }
+
+  /// Rows read at once from each input table
+  const hsize_t block_rows = 4096;
+
+  /// The configuration table holds a few tens of rows, read at once
+  std::vector<run_info_t> ReadRows(hid_t file, const std::string& table_name,
+                                   hsize_t memtype)
+  {
+    std::vector<run_info_t> rows(getTableSize(file, table_name));
+    if (!rows.empty()) readTable(file, table_name, memtype, rows.data());
+    return rows;
+  }
+
+  /// Sequential reader of a table, keeping one block of rows in memory
+  template <typename T>
+  class BlockReader
+  {
+  public:
+    BlockReader(hid_t file, const std::string& table_name, hsize_t memtype):
+      dataset_(-1), memtype_(memtype), size_(0), first_(0), next_(0)
+    {
+      if (!tableExists(file, table_name)) return;
+      dataset_ = H5Dopen2(file, table_name.c_str(), H5P_DEFAULT);
+      size_ = getTableSize(file, table_name);
+      Fill();
+    }
+    ~BlockReader() { if (dataset_ >= 0) H5Dclose(dataset_); }
+
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    /// True when all the rows have been consumed
+    bool AtEnd() const { return next_ == size_; }
+    /// Current row and the ones following it in memory
+    const T* Rows() const { return &rows_[next_ - first_]; }
+    /// Number of rows in memory from the current one
+    hsize_t Available() const { return first_ + rows_.size() - next_; }
+    /// Consume n rows, reading the next block when the current one is used up
+    void Advance(hsize_t n)
+    {
+      next_ += n;
+      if (next_ == first_ + rows_.size()) Fill();
+    }
+
+  private:
+    void Fill()
+    {
+      first_ = next_;
+      rows_.resize(std::min(block_rows, size_ - first_));
+      readBlock(rows_.data(), dataset_, memtype_, first_, rows_.size());
+    }
+
+    hid_t dataset_;
+    hsize_t memtype_;
+    hsize_t size_;  ///< rows of the table
+    hsize_t first_; ///< table row of the first row in memory
+    hsize_t next_;  ///< table row of the current row
+    std::vector<T> rows_;
+  };
+
+  bool AnyHasTable(const std::vector<hid_t>& inputs, const std::string& path)
+  {
+    for (auto file : inputs)
+      if (tableExists(file, path)) return true;
+    return false;
+  }
+
+}
+
+
+HDF5Merger::HDF5Merger()
+{
+}
+
+
+HDF5Merger::~HDF5Merger()
+{
+}
+
+
+void HDF5Merger::Merge(const std::vector<std::string>& inputs,
+                       const std::string& output)
+{
+  std::vector<hid_t> files;
+  for (const auto& name : inputs) {
+    hid_t file = H5Fopen(name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0) {
+      G4Exception("[HDF5Merger]", "Merge()", FatalException,
+                  ("Cannot open file " + name).c_str());
+    }
+    files.push_back(file);
+  }
+
+  hid_t out = H5Fcreate(output.c_str(), H5F_ACC_TRUNC,
+                        H5P_DEFAULT, H5P_DEFAULT);
+  if (out < 0) {
+    G4Exception("[HDF5Merger]", "Merge()", FatalException,
+                ("Cannot create file " + output).c_str());
+  }
+
+  std::string group_name = "/MC";
+  hid_t group = createGroup(out, group_name);
+
+  MergeConfiguration(files, group);
+  MergePositions(files, group);
+
+  MergeEventTable<sns_data_t>(files, group, group_name, "sns_response",
+                              createSensorDataType());
+  MergeEventTable<sns_tof_t>(files, group, group_name, "tof_sns_response",
+                             createSensorTofType());
+  MergeEventTable<hit_info_t>(files, group, group_name, "hits",
+                              createHitInfoType());
+  MergeEventTable<particle_info_t>(files, group, group_name, "particles",
+                                   createParticleInfoType());
+  MergeEventTable<charge_data_t>(files, group, group_name, "charge_response",
+                                 createChargeDataType());
+  H5Gclose(group);
+
+  if (AnyHasTable(files, "/DEBUG/steps")) {
+    std::string debug_group_name = "/DEBUG";
+    hid_t debug_group = createGroup(out, debug_group_name);
+    MergeEventTable<step_info_t>(files, debug_group, debug_group_name, "steps",
+                                 createStepType());
+    H5Gclose(debug_group);
+  }
+
+  H5Fclose(out);
+  for (auto file : files) H5Fclose(file);
+}
+
+
+void HDF5Merger::MergeConfiguration(const std::vector<hid_t>& inputs,
+                                    hid_t group)
+{
+  hsize_t memtype = createRunType();
+
+  // The configuration of the first file is kept, except for
+  // the counters, which are the sum over all files
+  std::vector<run_info_t> rows =
+    ReadRows(inputs.front(), "/MC/configuration", memtype);
+
+  std::map<std::string, long long> counters;
+  for (auto file : inputs) {
+    for (const auto& row : ReadRows(file, "/MC/configuration", memtype)) {
+      if (IsCounter(row.param_key))
+        counters[row.param_key] += std::stoll(row.param_value);
+    }
+  }
+
+  for (auto& row : rows) {
+    auto it = counters.find(row.param_key);
+    if (it == counters.end()) continue;
+    memset(row.param_value, 0, CONFLEN);
+    strcpy(row.param_value, std::to_string(it->second).c_str());
+  }
+
+  std::string table_name = "configuration";
+  hid_t table = createTable(group, table_name, memtype);
+  writeBlock(rows.data(), table, memtype, 0, rows.size());
+  H5Dclose(table);
+}
+
+
+void HDF5Merger::MergePositions(const std::vector<hid_t>& inputs, hid_t group)
+{
+  std::string path = "/MC/sns_positions";
+  if (!AnyHasTable(inputs, path)) return;
+
+  hsize_t memtype = createSensorPosType();
+  std::string table_name = "sns_positions";
+  hid_t table = createTable(group, table_name, memtype);
+  hsize_t counter = 0;
+
+  std::vector<sns_pos_t> rows;
+  std::set<unsigned int> ids;
+  for (auto file : inputs) {
+    BlockReader<sns_pos_t> reader(file, path, memtype);
+    while (!reader.AtEnd()) {
+      const sns_pos_t* block = reader.Rows();
+      hsize_t n = reader.Available();
+      for (hsize_t i=0; i<n; ++i)
+        if (ids.insert(block[i].sensor_id).second) rows.push_back(block[i]);
+      reader.Advance(n);
+
+      if (rows.size() >= block_rows) {
+        writeBlock(rows.data(), table, memtype, counter, rows.size());
+        counter += rows.size();
+        rows.clear();
+      }
+    }
+  }
+  writeBlock(rows.data(), table, memtype, counter, rows.size());
+
+  H5Dclose(table);
+}
+
+
+template <typename T>
+void HDF5Merger::MergeEventTable(const std::vector<hid_t>& inputs, hid_t group,
+                                 const std::string& group_name,
+                                 std::string table_name, hsize_t memtype)
+{
+  std::string path = group_name + "/" + table_name;
+
+  if (!AnyHasTable(inputs, path)) return;
+
+  std::vector<std::unique_ptr<BlockReader<T>>> parts;
+  for (auto file : inputs)
+    parts.emplace_back(new BlockReader<T>(file, path, memtype));
+
+  hid_t table = createTable(group, table_name, memtype);
+  hsize_t counter = 0;
+
+  // Each file holds its events in increasing order, so at each iteration
+  // all the rows of the lowest pending event are copied, one block of
+  // the input at a time
+  while (true) {
+    G4int next_part = -1;
+    for (size_t p=0; p<parts.size(); ++p) {
+      if (parts[p]->AtEnd()) continue;
+      if (next_part < 0 ||
+          parts[p]->Rows()->event_id < parts[next_part]->Rows()->event_id)
+        next_part = p;
+    }
+    if (next_part < 0) break;
+
+    auto& part = *parts[next_part];
+    auto event_id = part.Rows()->event_id;
+    while (!part.AtEnd() && part.Rows()->event_id == event_id) {
+      const T* rows = part.Rows();
+      hsize_t n = 0;
+      while (n < part.Available() && rows[n].event_id == event_id) ++n;
+      writeBlock(rows, table, memtype, counter, n);
+      counter += n;
+      part.Advance(n);
+    }
+  }
+
+  H5Dclose(table);
+}
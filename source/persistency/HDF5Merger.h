@@ -0,0 +1,44 @@
+// ----------------------------------------------------------------------------
+// petalosim | HDF5Merger.h
+//
+// This class merges several petalosim output files, written by
+// the processes of the same job, into a single file.
+// The event tables are merged in event order, sensor positions
+// are written once and the event counters of the configuration
+// table are added up. The tables are copied in blocks of a fixed
+// number of rows, so the memory used does not grow with the files.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef HDF5MERGER_H
+#define HDF5MERGER_H
+
+#include <hdf5.h>
+
+#include <string>
+#include <vector>
+
+class HDF5Merger
+{
+public:
+  /// Constructor
+  HDF5Merger();
+  /// Destructor
+  ~HDF5Merger();
+
+  /// Merge the input files into the output file
+  void Merge(const std::vector<std::string>& inputs, const std::string& output);
+
+private:
+  void MergeConfiguration(const std::vector<hid_t>& inputs, hid_t group);
+  void MergePositions(const std::vector<hid_t>& inputs, hid_t group);
+
+  /// Merge a table whose rows are grouped by increasing event ID
+  template <typename T>
+  void MergeEventTable(const std::vector<hid_t>& inputs, hid_t group,
+                       const std::string& group_name,
+                       std::string table_name, hsize_t memtype);
+};
+
+#endif
@@ -7,6 +7,9 @@
 // ----------------------------------------------------------------------------
 
 #include "HDF5Writer.h"
+#include "PerformanceMonitor.h"
+
+#include <G4Exception.hh>
 
 #include <sstream>
 #include <cstring>
@@ -20,7 +23,8 @@
 HDF5Writer::HDF5Writer():
   file_(0), irun_(0), ismp_(0),
   ismp_tof_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0), icharge_(0)
+  ipart_(0), ipos_(0), istep_(0), icharge_(0),
+  block_rows_(32768)
 {
 }
 
@@ -79,122 +83,121 @@ void HDF5Writer::Open(std::string fileName, bool debug)
   isOpen_ = true;
 }
 
-void HDF5Writer::Close()
+void HDF5Writer::Reopen(std::string fileName, bool debug,
+                        const std::vector<size_t>& counters)
 {
-  isOpen_=false;
-  H5Fclose(file_);
+  firstEvent_ = false;
+
+  // Every handle is checked, since a file left by an interrupted job
+  // may be damaged or may not have all the tables
+  auto check = [&fileName](hid_t id, const std::string& object) {
+    if (id < 0) {
+      G4Exception("[HDF5Writer]", "Reopen()", FatalException,
+                  ("Cannot open " + object + " in file " + fileName).c_str());
+    }
+    return id;
+  };
+
+  hid_t file = H5Fopen(fileName.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+  if (file < 0) {
+    G4Exception("[HDF5Writer]", "Reopen()", FatalException,
+                ("Cannot open file " + fileName).c_str());
+  }
+  file_  = file;
+  group_ = check(H5Gopen2(file_, "/MC", H5P_DEFAULT), "/MC");
+
+  memtypeRun_          = createRunType();
+  memtypeSnsData_      = createSensorDataType();
+  memtypeSnsTof_       = createSensorTofType();
+  memtypeHitInfo_      = createHitInfoType();
+  memtypeParticleInfo_ = createParticleInfoType();
+  memtypeSnsPos_       = createSensorPosType();
+  memtypeChargeData_   = createChargeDataType();
+
+  auto open_table = [&](const std::string& name) {
+    return check(H5Dopen2(group_, name.c_str(), H5P_DEFAULT), "/MC/" + name);
+  };
+  runTable_          = open_table("configuration");
+  snsDataTable_      = open_table("sns_response");
+  snsTofTable_       = open_table("tof_sns_response");
+  hitInfoTable_      = open_table("hits");
+  particleInfoTable_ = open_table("particles");
+  snsPosTable_       = open_table("sns_positions");
+  chargeDataTable_   = open_table("charge_response");
+
+  if (debug) {
+    memtypeStep_ = createStepType();
+    stepTable_   = check(H5Dopen2(file_, "/DEBUG/steps", H5P_DEFAULT),
+                         "/DEBUG/steps");
+  }
+
+  irun_     = counters[0];
+  ismp_     = counters[1];
+  ismp_tof_ = counters[2];
+  ihit_     = counters[3];
+  ipart_    = counters[4];
+  ipos_     = counters[5];
+  istep_    = counters[6];
+  icharge_  = counters[7];
+
+  // Discard the rows written after the counters were taken
+  auto truncate = [&](hid_t table, hsize_t rows, const std::string& name) {
+    hsize_t dims[1] = {rows};
+    if (H5Dset_extent(table, dims) < 0) {
+      G4Exception("[HDF5Writer]", "Reopen()", FatalException,
+                  ("Cannot truncate " + name + " in file " + fileName).c_str());
+    }
+  };
+  truncate(runTable_,          irun_,     "/MC/configuration");
+  truncate(snsDataTable_,      ismp_,     "/MC/sns_response");
+  truncate(snsTofTable_,       ismp_tof_, "/MC/tof_sns_response");
+  truncate(hitInfoTable_,      ihit_,     "/MC/hits");
+  truncate(particleInfoTable_, ipart_,    "/MC/particles");
+  truncate(snsPosTable_,       ipos_,     "/MC/sns_positions");
+  truncate(chargeDataTable_,   icharge_,  "/MC/charge_response");
+  if (debug)
+    truncate(stepTable_,       istep_,    "/DEBUG/steps");
+
+  isOpen_ = true;
 }
 
-void HDF5Writer::WriteRunInfo(const char* param_key, const char* param_value)
+std::vector<size_t> HDF5Writer::GetCounters() const
 {
-  run_info_t runData;
-  memset(runData.param_key,   0, CONFLEN);
-  memset(runData.param_value, 0, CONFLEN);
-  strcpy(runData.param_key, param_key);
-  strcpy(runData.param_value, param_value);
-  writeRun(&runData, runTable_, memtypeRun_, irun_);
-
-  irun_++;
+  return {irun_, ismp_, ismp_tof_, ihit_, ipart_, ipos_, istep_, icharge_};
 }
 
-void HDF5Writer::WriteSensorDataInfo(int evt_number, unsigned int sensor_id,
-                                     unsigned int charge)
+void HDF5Writer::Flush()
 {
-  sns_data_t snsData;
-  snsData.event_id = evt_number;
-  snsData.sensor_id = sensor_id;
-  snsData.charge = charge;
-  writeSnsData(&snsData, snsDataTable_, memtypeSnsData_, ismp_);
+  WriteStagedEvents();
 
-  ismp_++;
+  PerformanceMonitor::StageTimer timer(PerformanceMonitor::kFlush);
+  H5Fflush(file_, H5F_SCOPE_GLOBAL);
 }
 
-void HDF5Writer::WriteSensorTofInfo(int evt_number, int sensor_id, float time,
-                                    unsigned int track_id)
+long HDF5Writer::GetFileSize() const
 {
-  sns_tof_t snsTof;
-  snsTof.event_id = evt_number;
-  snsTof.sensor_id = sensor_id;
-  snsTof.time = time;
-  snsTof.track_id = track_id;
-  writeSnsTof(&snsTof, snsTofTable_, memtypeSnsTof_, ismp_tof_);
-
-  ismp_tof_++;
+  hsize_t size = 0;
+  H5Fget_filesize(file_, &size);
+  return (long)(size + staged_.Bytes());
 }
 
-
-void HDF5Writer::WriteHitInfo(int evt_number, int particle_indx,
-                              float hit_position_x, float hit_position_y,
-                              float hit_position_z, float hit_time,
-                              float hit_energy, const char* label)
+void HDF5Writer::Close()
 {
-  hit_info_t trueInfo;
-  trueInfo.event_id = evt_number;
-  memset(trueInfo.label, 0, STRLEN);
-  trueInfo.x = hit_position_x;
-  trueInfo.y = hit_position_y;
-  trueInfo.z = hit_position_z;
-  trueInfo.time = hit_time;
-  trueInfo.energy = hit_energy;
-  strcpy(trueInfo.label, label);
-  trueInfo.particle_id = particle_indx;
-  writeHit(&trueInfo,  hitInfoTable_, memtypeHitInfo_, ihit_);
-
-  ihit_++;
+  WriteStagedEvents();
+  isOpen_=false;
+  H5Fclose(file_);
 }
 
-void HDF5Writer::WriteParticleInfo(int evt_number, int particle_indx,
-                                   const char* particle_name, char primary,
-                                   int mother_id, float initial_vertex_x,
-                                   float initial_vertex_y,
-                                   float initial_vertex_z,
-                                   float initial_vertex_t,
-                                   float final_vertex_x,
-                                   float final_vertex_y, float final_vertex_z,
-                                   float final_vertex_t,
-                                   const char* initial_volume,
-                                   const char* final_volume, float momentum_x,
-                                   float momentum_y, float momentum_z,
-                                   float final_momentum_x,
-                                   float final_momentum_y,
-                                   float final_momentum_z, float kin_energy,
-                                   float length, const char* creator_proc,
-                                   const char* final_proc)
+void HDF5Writer::WriteRunInfo(const char* param_key, const char* param_value)
 {
-  particle_info_t trueInfo;
-  trueInfo.event_id = evt_number;
-  trueInfo.particle_id = particle_indx;
-  memset(trueInfo.particle_name, 0, STRLEN);
-  strcpy(trueInfo.particle_name, particle_name);
-  trueInfo.primary = primary;
-  trueInfo.mother_id = mother_id;
-  trueInfo.initial_x = initial_vertex_x;
-  trueInfo.initial_y = initial_vertex_y;
-  trueInfo.initial_z = initial_vertex_z;
-  trueInfo.initial_t = initial_vertex_t;
-  trueInfo.final_x = final_vertex_x;
-  trueInfo.final_y = final_vertex_y;
-  trueInfo.final_z = final_vertex_z;
-  trueInfo.final_t = final_vertex_t;
-  memset(trueInfo.initial_volume, 0, STRLEN);
-  strcpy(trueInfo.initial_volume, initial_volume);
-  memset(trueInfo.final_volume, 0, STRLEN);
-  strcpy(trueInfo.final_volume, final_volume);
-  trueInfo.initial_momentum_x = momentum_x;
-  trueInfo.initial_momentum_y = momentum_y;
-  trueInfo.initial_momentum_z = momentum_z;
-  trueInfo.final_momentum_x = final_momentum_x;
-  trueInfo.final_momentum_y = final_momentum_y;
-  trueInfo.final_momentum_z = final_momentum_z;
-  trueInfo.kin_energy = kin_energy;
-  trueInfo.length = length;
-  memset(trueInfo.creator_proc, 0, STRLEN);
-  strcpy(trueInfo.creator_proc, creator_proc);
-  memset(trueInfo.final_proc, 0, STRLEN);
-  strcpy(trueInfo.final_proc, final_proc);
-  writeParticle(&trueInfo,  particleInfoTable_, memtypeParticleInfo_, ipart_);
-
-  ipart_++;
+  run_info_t runData;
+  memset(runData.param_key,   0, CONFLEN);
+  memset(runData.param_value, 0, CONFLEN);
+  strcpy(runData.param_key, param_key);
+  strcpy(runData.param_value, param_value);
+  writeRun(&runData, runTable_, memtypeRun_, irun_);
+
+  irun_++;
 }
 
 void HDF5Writer::WriteSensorPosInfo(unsigned int sensor_id,
@@ -213,48 +216,51 @@ void HDF5Writer::WriteSensorPosInfo(unsigned int sensor_id,
   ipos_++;
 }
 
-void HDF5Writer::WriteStep(int evt_number,
-                           int particle_id, const char* particle_name,
-                           int step_id,
-                           const char* initial_volume,
-                           const char*   final_volume,
-                           const char*      proc_name,
-                           float initial_x, float initial_y, float initial_z,
-                           float   final_x, float   final_y, float   final_z)
+void HDF5Writer::WriteSensorPositions(const std::vector<sns_pos_t>& positions)
 {
-  step_info_t step;
-  step.event_id    = evt_number;
-  step.particle_id = particle_id;
-  memset(step.particle_name , 0,  STRLEN);
-  strcpy(step.particle_name ,  particle_name);
-  step.step_id    = step_id;
-  memset(step.initial_volume, 0, STRLEN);
-  strcpy(step.initial_volume, initial_volume);
-  memset(step.  final_volume, 0, STRLEN);
-  strcpy(step.  final_volume,   final_volume);
-  memset(step.     proc_name, 0, STRLEN);
-  strcpy(step.     proc_name,      proc_name);
-  step.initial_x   = initial_x;
-  step.initial_y   = initial_y;
-  step.initial_z   = initial_z;
-  step.  final_x   =   final_x;
-  step.  final_y   =   final_y;
-  step.  final_z   =   final_z;
-
-  writeStep(&step, stepTable_, memtypeStep_, istep_);
-
-  istep_++;
+  writeBlock(positions.data(), snsPosTable_, memtypeSnsPos_,
+             ipos_, positions.size());
+  ipos_ += positions.size();
+}
+
+void HDF5Writer::AppendEvent(const EventRowBuffer& rows)
+{
+  if (rows.Size() == 0) return;
+
+  // The events are stored one after the other, so appending the rows
+  // keeps each table in event order
+  staged_.Append(rows);
+
+  if (staged_.Size() >= block_rows_)
+    WriteStagedEvents();
 }
 
-void HDF5Writer::WriteChargeDataInfo(int evt_number, unsigned int sensor_id,
-                                     unsigned int time_bin, unsigned int charge)
+void HDF5Writer::WriteStagedEvents()
 {
-  charge_data_t chargeData;
-  chargeData.event_id = evt_number;
-  chargeData.sensor_id = sensor_id;
-  chargeData.time_bin = time_bin;
-  chargeData.charge = charge;
-  writeChargeData(&chargeData, chargeDataTable_, memtypeChargeData_, icharge_);
-
-  icharge_++;
+  if (staged_.Size() == 0) return;
+
+  PerformanceMonitor::StageTimer timer(PerformanceMonitor::kFlush);
+
+  writeBlock(staged_.sns_data.data(), snsDataTable_, memtypeSnsData_,
+             ismp_, staged_.sns_data.size());
+  ismp_ += staged_.sns_data.size();
+  writeBlock(staged_.sns_tof.data(), snsTofTable_, memtypeSnsTof_,
+             ismp_tof_, staged_.sns_tof.size());
+  ismp_tof_ += staged_.sns_tof.size();
+  writeBlock(staged_.hits.data(), hitInfoTable_, memtypeHitInfo_,
+             ihit_, staged_.hits.size());
+  ihit_ += staged_.hits.size();
+  writeBlock(staged_.particles.data(), particleInfoTable_, memtypeParticleInfo_,
+             ipart_, staged_.particles.size());
+  ipart_ += staged_.particles.size();
+  writeBlock(staged_.charge.data(), chargeDataTable_, memtypeChargeData_,
+             icharge_, staged_.charge.size());
+  icharge_ += staged_.charge.size();
+  // The steps table only exists in debug mode, when steps are stored
+  writeBlock(staged_.steps.data(), stepTable_, memtypeStep_,
+             istep_, staged_.steps.size());
+  istep_ += staged_.steps.size();
+
+  // The memory of the buffers is kept for the next block
+  staged_.Clear();
 }
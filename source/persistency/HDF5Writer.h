@@ -10,9 +10,11 @@
 #define HDF5WRITER_H
 
 #include "hdf5_functions.h"
+#include "EventRowBuffer.h"
 
 #include <hdf5.h>
 #include <iostream>
+#include <vector>
 
 class HDF5Writer
 {
@@ -26,40 +28,38 @@ public:
   //! open file
   void Open(std::string filename, bool debug);
 
+  //! open an existing file to continue writing it, keeping only
+  //! the number of rows of each table given by counters
+  void Reopen(std::string filename, bool debug,
+              const std::vector<size_t>& counters);
+
+  //! number of rows written to each table, in the order
+  //! run, sensor data, tof, hits, particles, positions, steps, charge
+  std::vector<size_t> GetCounters() const;
+
+  //! write to disk all the buffered data
+  void Flush();
+
+  //! current size of the file in bytes, including the staged rows
+  //! that have not been written yet
+  long GetFileSize() const;
+
   //! close file
   void Close();
 
   void WriteRunInfo(const char *param_key, const char *param_value);
-  void WriteSensorDataInfo(int evt_number, unsigned int sensor_id,
-                           unsigned int charge);
-  void WriteSensorTofInfo(int evt_number, int sensor_id, float time,
-                          unsigned int track_id);
-  void WriteHitInfo(int evt_number, int particle_indx, float hit_position_x,
-                    float hit_position_y, float hit_position_z, float hit_time,
-                    float hit_energy, const char *label);
-  void WriteParticleInfo(int evt_number, int particle_indx,
-                         const char *particle_name, char primary, int mother_id,
-                         float initial_vertex_x, float initial_vertex_y,
-                         float initial_vertex_z, float initial_vertex_t,
-                         float final_vertex_x, float final_vertex_y,
-                         float final_vertex_z, float final_vertex_t,
-                         const char *initial_volume, const char *final_volume,
-                         float momentum_x, float momentum_y, float momentum_z,
-                         float final_momentum_x, float final_momentum_y,
-                         float final_momentum_z, float kin_energy, float length,
-                         const char *creator_proc, const char *final_proc);
   void WriteSensorPosInfo(unsigned int sensor_id, const char *sensor_name,
                           float x, float y, float z);
-  void WriteStep(int evt_number,
-                 int particle_id, const char *particle_name,
-                 int step_id,
-                 const char *initial_volume,
-                 const char *final_volume,
-                 const char *proc_name,
-                 float initial_x, float initial_y, float initial_z,
-                 float final_x, float final_y, float final_z);
-  void WriteChargeDataInfo(int evt_number, unsigned int sensor_id,
-                           unsigned int time_bin, unsigned int charge);
+  //! write the positions of several sensors at once
+  void WriteSensorPositions(const std::vector<sns_pos_t>& positions);
+
+  //! stage the rows of a complete event; events must be appended in
+  //! event order and are written in blocks of rows
+  void AppendEvent(const EventRowBuffer& rows);
+
+private:
+  //! write the staged events and empty the staging buffers
+  void WriteStagedEvents();
 
 private:
   size_t file_; ///< HDF5 file
@@ -96,6 +96,9 @@ private:
   size_t ipos_;     ///< counter for sensor positions
   size_t istep_;    ///< counter for steps
   size_t icharge_;  ///< counter for charge
+
+  EventRowBuffer staged_; ///< rows of the events waiting to be written
+  size_t block_rows_;     ///< rows written at once
 };
 
 #endif
@@ -13,6 +13,9 @@
 #include "ChargeSD.h"
 #include "PetSaveAllSteppingAction.h"
 #include "PetIonizationSD.h"
+#include "PhotonSinkSD.h"
+#include "PetaloUtils.h"
+#include "PerformanceMonitor.h"
 
 #include "nexus/Trajectory.h"
 #include "nexus/TrajectoryMap.h"
@@ -29,26 +32,116 @@
 #include <G4RunManager.hh>
 #include <G4Run.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4NavigationHistory.hh>
+#include <G4TouchableHistory.hh>
+#include <G4ReplicaNavigation.hh>
+#include <G4VPVParameterisation.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <Randomize.hh>
 
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <set>
 
 using namespace nexus;
 using namespace CLHEP;
 
 REGISTER_CLASS(PetaloPersistencyManager, PersistencyManagerBase)
 
+namespace {
+
+  /// Does the volume or any of its daughters have a sensor?
+  G4bool HasSensors(G4LogicalVolume* lv)
+  {
+    if (dynamic_cast<ToFSD*>(lv->GetSensitiveDetector())) return true;
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i)
+      if (HasSensors(lv->GetDaughter(i)->GetLogicalVolume())) return true;
+    return false;
+  }
+
+  /// Add the ID and position of the sensors below the top volume of the
+  /// history, computed by their sensitive detectors as for their hits
+  void FindSensors(G4NavigationHistory& history, std::set<G4int>& stored,
+                   std::vector<sns_pos_t>& positions)
+  {
+    G4LogicalVolume* lv = history.GetTopVolume()->GetLogicalVolume();
+
+    ToFSD* sd = dynamic_cast<ToFSD*>(lv->GetSensitiveDetector());
+    if (sd) {
+      G4TouchableHistory touchable(history);
+      G4int id = sd->FindID(&touchable);
+      if (stored.insert(id).second) {
+        sns_pos_t pos;
+        pos.sensor_id = id;
+        setString(pos.sensor_name, sd->GetName().c_str(), STRLEN);
+        pos.x = touchable.GetTranslation().x();
+        pos.y = touchable.GetTranslation().y();
+        pos.z = touchable.GetTranslation().z();
+        positions.push_back(pos);
+      }
+    }
+
+    G4ReplicaNavigation replica_nav;
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+      G4VPhysicalVolume* pv = lv->GetDaughter(i);
+      // Parameterised volumes, such as the voxels of a phantom,
+      // are only visited if they contain sensors
+      if (!HasSensors(pv->GetLogicalVolume())) continue;
+
+      if (pv->VolumeType() == kNormal) {
+        history.NewLevel(pv, kNormal, pv->GetCopyNo());
+        FindSensors(history, stored, positions);
+        history.BackLevel();
+        continue;
+      }
+
+      EAxis axis;
+      G4int n_copies;
+      G4double width, offset;
+      G4bool consuming;
+      pv->GetReplicationData(axis, n_copies, width, offset, consuming);
+      for (G4int k=0; k<n_copies; ++k) {
+        if (pv->VolumeType() == kReplica)
+          replica_nav.ComputeTransformation(k, pv);
+        else
+          pv->GetParameterisation()->ComputeTransformation(k, pv);
+        pv->SetCopyNo(k);
+        history.NewLevel(pv, pv->VolumeType(), k);
+        FindSensors(history, stored, positions);
+        history.BackLevel();
+      }
+    }
+  }
+
+}
+
 PetaloPersistencyManager::PetaloPersistencyManager():
   PersistencyManagerBase(), msg_(0), output_file_("petalo_out"),
   store_evt_(true), store_steps_(false),
   interacting_evt_(false), save_int_e_numb_(false),
-  efield_(0), saved_evts_(0), interacting_evts_(0),
+  step_source_(nullptr), efield_(0),
+  all_sns_positions_(false), file_has_all_sns_(false),
+  saved_evts_(0), interacting_evts_(0),
   nevt_(0), start_id_(0), first_evt_(true),
+  event_seeding_(false), run_seed_set_(false), run_seed_(0), processed_evts_(0),
+  first_index_(0),
+  checkpoint_interval_(0), resume_(false), resumed_evts_(0),
+  max_evts_file_(0), max_bytes_file_(0), file_index_(0),
+  file_first_evt_(0), file_saved_(0), file_interacting_(0),
   thr_charge_(0), tof_time_(50.*nanosecond), sns_only_(false),
   save_tot_charge_(true), sipm_cells_(false), h5writer_(0)
 {
+  // The monitor is created here so that its commands exist
+  // when the configuration macros are executed
+  PerformanceMonitor::Instance();
+
   msg_ = new G4GenericMessenger(this, "/petalosim/persistency/");
   msg_->DeclareProperty("output_file", output_file_, "Path of output file.");
   msg_->DeclareProperty("start_id", start_id_,
@@ -61,6 +154,34 @@ PetaloPersistencyManager::PetaloPersistencyManager():
                         "If true, total charge is saved.");
   msg_->DeclareProperty("sipm_cells", sipm_cells_,
                         "True if each individual cell of SiPMs is simulated.");
+  msg_->DeclareProperty("all_sensor_positions", all_sns_positions_,
+                        "If true, the positions of all the sensors are saved, "
+                        "not only those of the sensors with charge.");
+  msg_->DeclareProperty("event_seeding", event_seeding_,
+                        "If true, the random engine is seeded for each event "
+                        "from the run seed and the event ID, which is then "
+                        "start_id plus the number of events processed before.");
+
+  G4GenericMessenger::Command& ckpt_cmd =
+    msg_->DeclareProperty("checkpoint_interval", checkpoint_interval_,
+                          "Number of events between checkpoints "
+                          "(0 means no checkpoints).");
+  ckpt_cmd.SetParameterName("checkpoint_interval", false);
+  ckpt_cmd.SetRange("checkpoint_interval>=0");
+
+  G4GenericMessenger::Command& max_evts_cmd =
+    msg_->DeclareProperty("max_events_per_file", max_evts_file_,
+                          "Maximum number of saved events per output file, "
+                          "after which a new file is opened (0 means no limit).");
+  max_evts_cmd.SetParameterName("max_events_per_file", false);
+  max_evts_cmd.SetRange("max_events_per_file>=0");
+
+  G4GenericMessenger::Command& max_bytes_cmd =
+    msg_->DeclareProperty("max_bytes_per_file", max_bytes_file_,
+                          "Maximum size in bytes of each output file, "
+                          "after which a new file is opened (0 means no limit).");
+  max_bytes_cmd.SetParameterName("max_bytes_per_file", false);
+  max_bytes_cmd.SetRange("max_bytes_per_file>=0");
 
   G4GenericMessenger::Command& time_cmd =
     msg_->DeclareProperty("tof_time", tof_time_,
@@ -87,9 +208,35 @@ PetaloPersistencyManager::~PetaloPersistencyManager()
 
 void PetaloPersistencyManager::OpenFile()
 {
+  delete h5writer_;
   h5writer_ = new HDF5Writer();
-  G4String hdf5file = output_file_ + ".h5";
-  h5writer_->Open(hdf5file, store_steps_);
+  file_has_all_sns_ = false;
+
+  // The checkpoint also tells which file is continued
+  std::vector<size_t> counters;
+  if (resume_)
+    counters = ReadCheckpoint();
+
+  G4String hdf5file = OutputFileName();
+
+  if (resume_) {
+    h5writer_->Reopen(hdf5file, store_steps_, counters);
+    resume_ = false;
+    G4cout << "[PetaloPersistencyManager] Resuming " << hdf5file << " after "
+           << processed_evts_ << " events." << G4endl;
+  }
+  else
+    h5writer_->Open(hdf5file, store_steps_);
+
+  // The first event of the file is seeded here, since the primary
+  // particles are generated before any user event action is called
+  if (event_seeding_) {
+    if (!run_seed_set_) {
+      run_seed_     = HepRandom::getTheSeed();
+      run_seed_set_ = true;
+    }
+    SeedEvent(start_id_ + processed_evts_);
+  }
   return;
 }
 
@@ -97,7 +244,13 @@ void PetaloPersistencyManager::OpenFile()
 
 void PetaloPersistencyManager::CloseFile()
 {
+  // The file may have been closed already, before the job
+  // is split in several processes
+  if (!h5writer_) return;
+
   h5writer_->Close();
+  delete h5writer_;
+  h5writer_ = 0;
   return;
 }
 
@@ -105,29 +258,52 @@ void PetaloPersistencyManager::CloseFile()
 
 G4bool PetaloPersistencyManager::Store(const G4Event* event)
 {
+  PerformanceMonitor::StageTimer timer(PerformanceMonitor::kStore);
+
+  // A full file is only replaced when there is an event to store,
+  // so that the last file of a run is never left empty
+  if (store_evt_ && RollsOver() && FileIsFull())
+    RollFile();
+
+  // The geometry is complete by the end of the first event
+  if (all_sns_positions_ && !file_has_all_sns_)
+    StoreAllSensorPositions();
+
+  G4int event_id = start_id_ + processed_evts_;
+  processed_evts_++;
+
+  // Seed the next event
+  if (event_seeding_)
+    SeedEvent(start_id_ + processed_evts_);
+
   if (interacting_evt_) {
     interacting_evts_++;
   }
 
   if (!store_evt_) {
     TrajectoryMap::Clear();
-    if (store_steps_) {
-      PetSaveAllSteppingAction* sa = (PetSaveAllSteppingAction*)
-        G4RunManager::GetRunManager()->GetUserSteppingAction();
-      sa->Reset();
+    if (store_steps_ && step_source_) {
+      step_source_->Reset();
     }
+    if (checkpoint_interval_ > 0 && processed_evts_ % checkpoint_interval_ == 0)
+      WriteCheckpoint();
     return false;
   }
 
   saved_evts_++;
-
+  PerformanceMonitor::Instance().CountSavedEvent();
 
   if (first_evt_) {
     first_evt_ = false;
     nevt_ = start_id_;
   }
 
-  if (store_steps_)
+  // With event seeding, the saved ID is the one needed to regenerate
+  // the event, so it also counts the events that are not saved
+  if (event_seeding_)
+    nevt_ = event_id;
+
+  if (store_steps_ && step_source_)
     StoreSteps();
 
   if (sns_only_ == false) {
@@ -136,11 +312,18 @@ G4bool PetaloPersistencyManager::Store(const G4Event* event)
 
   StoreHits(event->GetHCofThisEvent());
 
+  // The rows of the event are handed to the writer all at once
+  h5writer_->AppendEvent(event_rows_);
+  event_rows_.Clear();
+
   nevt_++;
 
   TrajectoryMap::Clear();
   StoreCurrentEvent(true);
 
+  if (checkpoint_interval_ > 0 && processed_evts_ % checkpoint_interval_ == 0)
+    WriteCheckpoint();
+
   return true;
 }
 
@@ -202,19 +385,33 @@ void PetaloPersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
       mother_id = trj->GetParentID();
     }
 
-    h5writer_->WriteParticleInfo(nevt_, trackid, trj->GetParticleName().c_str(),
-				 primary, mother_id,
-				 (float)ini_xyz.x(), (float)ini_xyz.y(),
-                                 (float)ini_xyz.z(), (float)ini_t,
-				 (float)final_xyz.x(), (float)final_xyz.y(),
-                                 (float)final_xyz.z(), (float)final_t,
-				 ini_volume.c_str(), final_volume.c_str(),
-				 (float)ini_mom.x(), (float)ini_mom.y(),
-                                 (float)ini_mom.z(), (float)final_mom.x(),
-                                 (float)final_mom.y(), (float)final_mom.z(),
-				 kin_energy, length,
-                                 trj->GetCreatorProcess().c_str(),
-				 trj->GetFinalProcess().c_str());
+    particle_info_t row;
+    row.event_id    = nevt_;
+    row.particle_id = trackid;
+    setString(row.particle_name, trj->GetParticleName().c_str(), STRLEN);
+    row.primary   = primary;
+    row.mother_id = mother_id;
+    row.initial_x = ini_xyz.x();
+    row.initial_y = ini_xyz.y();
+    row.initial_z = ini_xyz.z();
+    row.initial_t = ini_t;
+    row.final_x   = final_xyz.x();
+    row.final_y   = final_xyz.y();
+    row.final_z   = final_xyz.z();
+    row.final_t   = final_t;
+    setString(row.initial_volume, ini_volume.c_str(), STRLEN);
+    setString(row.final_volume, final_volume.c_str(), STRLEN);
+    row.initial_momentum_x = ini_mom.x();
+    row.initial_momentum_y = ini_mom.y();
+    row.initial_momentum_z = ini_mom.z();
+    row.final_momentum_x   = final_mom.x();
+    row.final_momentum_y   = final_mom.y();
+    row.final_momentum_z   = final_mom.z();
+    row.kin_energy = kin_energy;
+    row.length     = length;
+    setString(row.creator_proc, trj->GetCreatorProcess().c_str(), STRLEN);
+    setString(row.final_proc, trj->GetFinalProcess().c_str(), STRLEN);
+    event_rows_.particles.push_back(row);
 
   }
 }
@@ -276,10 +473,16 @@ void PetaloPersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
      G4int trackid = hit->GetTrackID();
      G4ThreeVector hit_pos = hit->GetPosition();
 
-     h5writer_->WriteHitInfo(nevt_, trackid,
-			     hit_pos[0], hit_pos[1], hit_pos[2],
-			     hit->GetTime(), hit->GetEnergyDeposit(),
-			     sdname.c_str());
+     hit_info_t row;
+     row.event_id = nevt_;
+     row.x = hit_pos[0];
+     row.y = hit_pos[1];
+     row.z = hit_pos[2];
+     row.time   = hit->GetTime();
+     row.energy = hit->GetEnergyDeposit();
+     setString(row.label, sdname.c_str(), STRLEN);
+     row.particle_id = trackid;
+     event_rows_.hits.push_back(row);
    }
 
  }
@@ -297,18 +500,22 @@ void PetaloPersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
     if (!hit) continue;
 
     G4int s_id   = hit->GetSnsID();
-    G4int charge = hit->GetDetPhotons();
+    // Photons may carry a weight different from one
+    // if variance reduction is applied
+    G4int charge = (G4int)(hit->GetWeightedPhotons() + 0.5);
+    PerformanceMonitor::Instance().AddDetectedPhotons(hit->GetWeightedPhotons());
 
     if (charge > thr_charge_){
       std::string sdname = hits->GetSDname();
       G4ThreeVector xyz = hit->GetPosition();
       if (save_tot_charge_ == true) {
-        h5writer_->WriteSensorDataInfo(nevt_, (unsigned int)s_id,
-                                       (unsigned int)charge);
+        event_rows_.sns_data.push_back({nevt_, (unsigned int)s_id,
+                                        (unsigned int)charge});
       }
-      std::vector<G4int>::iterator pos_it =
-        std::find(sns_posvec_.begin(), sns_posvec_.end(), s_id);
-      if (pos_it == sns_posvec_.end()) {
+      // With all the positions saved, the list is not searched
+      if (!file_has_all_sns_ &&
+          std::find(sns_posvec_.begin(), sns_posvec_.end(), s_id) ==
+          sns_posvec_.end()) {
         h5writer_->WriteSensorPosInfo((unsigned int)s_id, sdname.c_str(),
                                       (float)xyz.x(), (float)xyz.y(),
                                       (float)xyz.z());
@@ -318,19 +525,10 @@ void PetaloPersistencyManager::StoreSensorHits(G4VHitsCollection* hc)
       const std::map<G4double, G4int>& phot = hit->GetPhotonMap();
       std::map<G4double, G4int>::const_iterator it;
       for (it = phot.begin(); it != phot.end(); ++it) {
-        if (sipm_cells_) {
-          h5writer_->WriteSensorTofInfo(nevt_, (unsigned int)s_id,
-                                        (float)it->first,
-                                        (unsigned int)it->second);
-        } else {
-          if (it->first <= tof_time_){
-            h5writer_->WriteSensorTofInfo(nevt_, (unsigned int)s_id,
-                                          (float)it->first,
-                                          (unsigned int)it->second);
-          } else {
-            break;
-          }
-        }  
+        if (!sipm_cells_ && it->first > tof_time_) break;
+        event_rows_.sns_tof.push_back({nevt_, (unsigned int)s_id,
+                                       (float)it->first,
+                                       (unsigned int)it->second});
       }
 
     }
@@ -358,8 +556,8 @@ void PetaloPersistencyManager::StoreChargeHits(G4VHitsCollection* hc)
     for (it = wvfm.begin(); it != wvfm.end(); ++it) {
       unsigned int time_bin = (unsigned int)((*it).first/wire_bin_size_+0.5);
       unsigned int charge   = (unsigned int)((*it).second+0.5);
-      h5writer_->WriteChargeDataInfo(nevt_, (unsigned int)hit->GetSensorID(),
-                                     time_bin, charge);
+      event_rows_.charge.push_back({nevt_, (unsigned int)hit->GetSensorID(),
+                                    time_bin, charge});
     }
 
 
@@ -377,10 +575,29 @@ void PetaloPersistencyManager::StoreChargeHits(G4VHitsCollection* hc)
   }
 }
 
+void PetaloPersistencyManager::StoreAllSensorPositions()
+{
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world) return;
+
+  std::set<G4int> stored(sns_posvec_.begin(), sns_posvec_.end());
+  std::vector<sns_pos_t> positions;
+
+  G4NavigationHistory history;
+  history.SetFirstEntry(world);
+  FindSensors(history, stored, positions);
+
+  for (const auto& pos : positions) sns_posvec_.push_back(pos.sensor_id);
+  h5writer_->WriteSensorPositions(positions);
+  file_has_all_sns_ = true;
+}
+
+
+
 void PetaloPersistencyManager::StoreSteps()
 {
-  PetSaveAllSteppingAction* sa = (PetSaveAllSteppingAction*)
-    G4RunManager::GetRunManager()->GetUserSteppingAction();
+  PetSaveAllSteppingAction* sa = step_source_;
 
   StepContainer<G4String> initial_volumes = sa->get_initial_volumes();
   StepContainer<G4String>   final_volumes = sa->get_final_volumes  ();
@@ -395,16 +612,21 @@ void PetaloPersistencyManager::StoreSteps()
     G4String                   particle_name = key.second;
 
     for (size_t step_id=0; step_id < it->second.size(); ++step_id) {
-      h5writer_->WriteStep(nevt_, track_id, particle_name, step_id,
-                           initial_volumes[key][step_id],
-                           final_volumes[key][step_id],
-                           proc_names[key][step_id],
-                           initial_poss[key][step_id].x(),
-                           initial_poss[key][step_id].y(),
-                           initial_poss[key][step_id].z(),
-                           final_poss[key][step_id].x(),
-                           final_poss[key][step_id].y(),
-                           final_poss[key][step_id].z());
+      step_info_t row;
+      row.event_id    = nevt_;
+      row.particle_id = track_id;
+      setString(row.particle_name, particle_name.c_str(), STRLEN);
+      row.step_id     = step_id;
+      setString(row.initial_volume, initial_volumes[key][step_id].c_str(), STRLEN);
+      setString(row.final_volume, final_volumes[key][step_id].c_str(), STRLEN);
+      setString(row.proc_name, proc_names[key][step_id].c_str(), STRLEN);
+      row.initial_x   = initial_poss[key][step_id].x();
+      row.initial_y   = initial_poss[key][step_id].y();
+      row.initial_z   = initial_poss[key][step_id].z();
+      row.final_x     = final_poss[key][step_id].x();
+      row.final_y     = final_poss[key][step_id].y();
+      row.final_z     = final_poss[key][step_id].z();
+      event_rows_.steps.push_back(row);
     }
   }
   sa->Reset();
@@ -412,25 +634,74 @@ void PetaloPersistencyManager::StoreSteps()
 
 G4bool PetaloPersistencyManager::Store(const G4Run*)
 {
-
   // Store the number of events to be processed
   NexusApp* app = (NexusApp*) G4RunManager::GetRunManager();
-  G4int num_events = app->GetNumberOfEventsToBeProcessed();
+  G4int num_events =
+    app->GetNumberOfEventsToBeProcessed() + resumed_evts_ - file_first_evt_;
+
+  PerformanceMonitor& monitor = PerformanceMonitor::Instance();
+  if (monitor.IsEnabled()) {
+    monitor.Print();
+    for (const auto& [key, value] : monitor.Summary())
+      SetRunInfo(key, value);
+    monitor.Reset();
+  }
+
+  WriteConfiguration(num_events);
+
+  return true;
+}
 
+std::map<G4String, G4long> PetaloPersistencyManager::KilledSinkPhotons() const
+{
+  std::map<G4String, G4long> killed = resumed_sink_photons_;
+
+  PhotonSinkSD* sinksd = dynamic_cast<PhotonSinkSD*>
+    (G4SDManager::GetSDMpointer()->FindSensitiveDetector(PhotonSinkSD::GetSDName(),
+                                                         false));
+  if (sinksd) {
+    for (const auto& [volume, n] : sinksd->GetKilledPhotons())
+      killed[volume] += n;
+  }
+
+  return killed;
+}
+
+void PetaloPersistencyManager::WriteConfiguration(G4int num_events)
+{
+  // The event counters refer to the events of the current file
   G4String key = "num_events";
   h5writer_->WriteRunInfo(key, std::to_string(num_events).c_str());
   key = "saved_events";
-  h5writer_->WriteRunInfo(key, std::to_string(saved_evts_).c_str());
+  h5writer_->WriteRunInfo(key, std::to_string(saved_evts_ - file_saved_).c_str());
 
   if (save_int_e_numb_) {
     key = "interacting_events";
-    h5writer_->WriteRunInfo(key,  std::to_string(interacting_evts_).c_str());
+    h5writer_->WriteRunInfo(key,
+      std::to_string(interacting_evts_ - file_interacting_).c_str());
    }
+  // Optical photons killed in each photon sink volume during the file
+  for (const auto& [volume, killed] : KilledSinkPhotons()) {
+    auto before = file_sink_photons_.find(volume);
+    G4long n = killed - (before != file_sink_photons_.end() ? before->second : 0);
+    key = "photon_sink_" + volume;
+    h5writer_->WriteRunInfo(key, std::to_string(n).c_str());
+  }
+
   key = "wire_bin_size";
   h5writer_->WriteRunInfo(key, (std::to_string(wire_bin_size_/nanosecond)+" ns").c_str());
   key = "electric_field";
   h5writer_->WriteRunInfo(key, (std::to_string(efield_)+" V/cm").c_str());
 
+  if (event_seeding_) {
+    key = "run_seed";
+    h5writer_->WriteRunInfo(key, std::to_string(run_seed_).c_str());
+  }
+
+  for (const auto& [info_key, value] : run_info_)
+    h5writer_->WriteRunInfo(info_key.c_str(), value.c_str());
+
+  secondary_macros_.clear();
   SaveConfigurationInfo(init_macro_);
   for (unsigned long i=0; i<macros_.size(); i++) {
     SaveConfigurationInfo(macros_[i]);
@@ -441,8 +712,179 @@ G4bool PetaloPersistencyManager::Store(const G4Run*)
   for (unsigned long i=0; i<secondary_macros_.size(); i++) {
     SaveConfigurationInfo(secondary_macros_[i]);
   }
+}
 
-  return true;
+G4bool PetaloPersistencyManager::FileIsFull() const
+{
+  if (max_evts_file_ > 0 && saved_evts_ - file_saved_ >= max_evts_file_)
+    return true;
+  if (max_bytes_file_ > 0 && h5writer_->GetFileSize() >= max_bytes_file_)
+    return true;
+  return false;
+}
+
+void PetaloPersistencyManager::RollFile()
+{
+  WriteConfiguration(processed_evts_ - file_first_evt_);
+  CloseFile();
+
+  file_index_++;
+  file_first_evt_   = processed_evts_;
+  file_saved_       = saved_evts_;
+  file_interacting_ = interacting_evts_;
+  file_sink_photons_ = KilledSinkPhotons();
+
+  // Each file has the positions of its own sensors
+  sns_posvec_.clear();
+  charge_posvec_.clear();
+
+  OpenFile();
+}
+
+G4String PetaloPersistencyManager::OutputFileName() const
+{
+  G4String hdf5file = output_file_;
+
+  if (RollsOver()) {
+    std::ostringstream index;
+    index << "." << std::setw(3) << std::setfill('0') << file_index_;
+    hdf5file += index.str();
+  }
+
+  return hdf5file + ".h5";
+}
+
+void PetaloPersistencyManager::WriteCheckpoint()
+{
+  h5writer_->Flush();
+
+  // The checkpoint is written to a temporary file and then renamed,
+  // so that an interruption never leaves a partial checkpoint
+  G4String ckpt_file = output_file_ + ".ckpt";
+  G4String tmp_file  = ckpt_file + ".tmp";
+
+  std::ofstream ckpt(tmp_file);
+  ckpt << "processed_events " << processed_evts_ << "\n"
+       << "event_id " << nevt_ << "\n"
+       << "first_event " << first_evt_ << "\n"
+       << "saved_events " << saved_evts_ << "\n"
+       << "interacting_events " << interacting_evts_ << "\n"
+       << "run_seed " << run_seed_set_ << " " << run_seed_ << "\n"
+       << "file " << file_index_ << " " << file_first_evt_ << " "
+       << file_saved_ << " " << file_interacting_ << "\n";
+
+  ckpt << "writer_rows";
+  for (auto rows : h5writer_->GetCounters()) ckpt << " " << rows;
+  ckpt << "\n";
+
+  ckpt << "sensor_positions " << sns_posvec_.size();
+  for (auto id : sns_posvec_) ckpt << " " << id;
+  ckpt << "\n";
+
+  ckpt << "charge_positions " << charge_posvec_.size();
+  for (auto id : charge_posvec_) ckpt << " " << id;
+  ckpt << "\n";
+
+  // The performance monitor is not saved: after resuming, its summary
+  // only measures the events simulated by the resumed job
+  auto sink_photons = KilledSinkPhotons();
+  ckpt << "photon_sinks " << sink_photons.size();
+  for (const auto& [volume, killed] : sink_photons)
+    ckpt << " " << volume << " " << killed;
+  ckpt << "\n";
+
+  ckpt << "file_photon_sinks " << file_sink_photons_.size();
+  for (const auto& [volume, killed] : file_sink_photons_)
+    ckpt << " " << volume << " " << killed;
+  ckpt << "\n";
+
+  ckpt << "engine\n";
+  HepRandom::getTheEngine()->put(ckpt);
+  ckpt.close();
+
+  if (!ckpt || std::rename(tmp_file.c_str(), ckpt_file.c_str()) != 0) {
+    G4Exception("[PetaloPersistencyManager]", "WriteCheckpoint()",
+                JustWarning, ("Cannot write checkpoint " + ckpt_file).c_str());
+  }
+}
+
+std::vector<size_t> PetaloPersistencyManager::ReadCheckpoint()
+{
+  G4String ckpt_file = output_file_ + ".ckpt";
+  std::ifstream ckpt(ckpt_file);
+  if (!ckpt.is_open()) {
+    G4Exception("[PetaloPersistencyManager]", "ReadCheckpoint()",
+                FatalException, ("Cannot open checkpoint " + ckpt_file).c_str());
+  }
+
+  auto read_key = [&](const std::string& expected) {
+    std::string key;
+    ckpt >> key;
+    if (key != expected) {
+      G4Exception("[PetaloPersistencyManager]", "ReadCheckpoint()",
+                  FatalException, ("Wrong format of checkpoint " + ckpt_file +
+                                   ", expected " + expected).c_str());
+    }
+  };
+
+  read_key("processed_events");   ckpt >> processed_evts_;
+  read_key("event_id");           ckpt >> nevt_;
+  read_key("first_event");        ckpt >> first_evt_;
+  read_key("saved_events");       ckpt >> saved_evts_;
+  read_key("interacting_events"); ckpt >> interacting_evts_;
+  read_key("run_seed");           ckpt >> run_seed_set_ >> run_seed_;
+  read_key("file");               ckpt >> file_index_ >> file_first_evt_
+                                       >> file_saved_ >> file_interacting_;
+
+  read_key("writer_rows");
+  std::vector<size_t> counters(h5writer_->GetCounters().size());
+  for (auto& rows : counters) ckpt >> rows;
+
+  size_t n;
+  read_key("sensor_positions");
+  ckpt >> n;
+  sns_posvec_.resize(n);
+  for (auto& id : sns_posvec_) ckpt >> id;
+
+  read_key("charge_positions");
+  ckpt >> n;
+  charge_posvec_.resize(n);
+  for (auto& id : charge_posvec_) ckpt >> id;
+
+  read_key("photon_sinks");
+  ckpt >> n;
+  resumed_sink_photons_.clear();
+  for (size_t i=0; i<n; ++i) {
+    G4String volume;
+    ckpt >> volume;
+    ckpt >> resumed_sink_photons_[volume];
+  }
+
+  read_key("file_photon_sinks");
+  ckpt >> n;
+  file_sink_photons_.clear();
+  for (size_t i=0; i<n; ++i) {
+    G4String volume;
+    ckpt >> volume;
+    ckpt >> file_sink_photons_[volume];
+  }
+
+  read_key("engine");
+  HepRandom::getTheEngine()->get(ckpt);
+
+  if (ckpt.fail()) {
+    G4Exception("[PetaloPersistencyManager]", "ReadCheckpoint()",
+                FatalException, ("Cannot read checkpoint " + ckpt_file).c_str());
+  }
+
+  resumed_evts_ = processed_evts_;
+
+  return counters;
+}
+
+void PetaloPersistencyManager::SeedEvent(G4int event_id)
+{
+  SeedEngine(run_seed_, event_id);
 }
 
 void PetaloPersistencyManager::SaveConfigurationInfo(G4String file_name)
@@ -3,6 +3,9 @@
 //
 // This class writes all the relevant information of the simulation
 // to an ouput file.
+// Events are stored from a single thread: nexus runs a sequential
+// G4RunManager and the trajectories are read from its process-wide
+// TrajectoryMap. Runs are parallelized with processes instead (petalo -j).
 //
 // The PETALO Collaboration
 // ----------------------------------------------------------------------------
@@ -10,8 +13,12 @@
 #ifndef P_PERSISTENCY_MANAGER_H
 #define P_PERSISTENCY_MANAGER_H
 
+#include "EventRowBuffer.h"
+
 #include "nexus/PersistencyManagerBase.h"
 #include <G4VPersistencyManager.hh>
+#include <map>
+#include <utility>
 #include <vector>
 
 class G4GenericMessenger;
@@ -20,6 +27,7 @@ class G4HCofThisEvent;
 class G4VHitsCollection;
 
 class HDF5Writer;
+class PetSaveAllSteppingAction;
 
 class PetaloPersistencyManager : public PersistencyManagerBase
 {
@@ -35,10 +43,35 @@ public:
   void StoreCurrentEvent(G4bool);
   void InteractingEvent(G4bool);
   void StoreSteps(G4bool);
+  /// Set the stepping action whose steps are saved
+  void SetStepSource(PetSaveAllSteppingAction*);
   void SaveNumbOfInteractingEvents(G4bool);
 
   void SetElectricField(G4double);
 
+  /// Add an entry to the configuration table of the output file
+  void SetRunInfo(const G4String& key, const G4String& value);
+
+  /// Continue the output file from its last checkpoint
+  void SetResume(G4bool);
+  /// Number of events processed, including those before resuming
+  G4int GetProcessedEvents() const;
+
+  /// Is the output split in several files of limited size?
+  G4bool RollsOver() const;
+
+  const G4String& GetOutputFile() const;
+  void SetOutputFile(const G4String&);
+  G4int GetStartID() const;
+  void SetStartID(G4int);
+
+  /// Index in the whole run of the first event of this process,
+  /// when the run is split in several processes
+  void SetFirstEventIndex(G4int);
+  /// Index in the whole run of the event being generated, counting
+  /// the events of the previous processes and those before resuming
+  G4int CurrentEventIndex() const;
+
   ///
   virtual G4bool Store(const G4Event *);
   virtual G4bool Store(const G4Run *);
@@ -59,9 +92,34 @@ private:
   void StoreSensorHits(G4VHitsCollection *);
   void StoreChargeHits(G4VHitsCollection *);
   void StoreSteps();
+  /// Save the positions of the sensors without charge so far,
+  /// found by walking the whole geometry tree
+  void StoreAllSensorPositions();
 
   void SaveConfigurationInfo(G4String history);
 
+  /// Seed the random engine for the given global event ID
+  void SeedEvent(G4int event_id);
+
+  /// Flush the output file and save the state needed to resume the run
+  void WriteCheckpoint();
+  /// Restore the state of the last checkpoint and return
+  /// the number of rows of each table of the output file
+  std::vector<size_t> ReadCheckpoint();
+
+  /// Optical photons killed in each photon sink volume,
+  /// including those before resuming
+  std::map<G4String, G4long> KilledSinkPhotons() const;
+
+  /// Write the configuration table, with the counters of the current file
+  void WriteConfiguration(G4int num_events);
+  /// Name of the current output file
+  G4String OutputFileName() const;
+  /// Has the current file reached any of the size limits?
+  G4bool FileIsFull() const;
+  /// Close the current file and continue in a new one
+  void RollFile();
+
 private:
   G4GenericMessenger *msg_; ///< User configuration messenger
   G4String output_file_; ///< Output file name
@@ -73,10 +131,17 @@ private:
   G4bool interacting_evt_; ///< Has the current event interacted in ACTIVE?
   G4bool save_int_e_numb_; ///< Should we save the number of interacting events in the configuration table?
 
+  PetSaveAllSteppingAction* step_source_; ///< Stepping action with the steps to be saved
+
   G4double efield_; ///< Value of the electric field used in NEST
 
+  /// Entries of the configuration table set by other components
+  std::vector<std::pair<G4String, G4String>> run_info_;
+
   std::vector<G4int> sns_posvec_;
   std::vector<G4int> charge_posvec_;
+  G4bool all_sns_positions_;  ///< Save the positions of all the sensors?
+  G4bool file_has_all_sns_;   ///< Are all of them in the current file?
 
   G4int saved_evts_;                      ///< number of events to be saved
   G4int interacting_evts_;                ///< number of events interacting in ACTIVE
@@ -86,12 +151,32 @@ private:
   G4int start_id_;   ///< ID for the first event in file
   G4bool first_evt_; ///< true only for the first event of the run
 
+  G4bool event_seeding_; ///< Seed the random engine for each event?
+  G4bool run_seed_set_;  ///< Has the run seed been read?
+  G4long run_seed_;      ///< Seed from which the event seeds are derived
+  G4int processed_evts_; ///< Number of events processed, saved or not
+  G4int first_index_;    ///< Index in the run of the first event of the process
+
+  G4int checkpoint_interval_; ///< Events between checkpoints
+  G4bool resume_;             ///< Continue from the last checkpoint?
+  G4int resumed_evts_;        ///< Events processed before resuming
+  std::map<G4String, G4long> resumed_sink_photons_; ///< Killed before resuming
+
+  G4int max_evts_file_;    ///< Maximum number of saved events per file
+  G4long max_bytes_file_;  ///< Maximum size of each file (bytes)
+  G4int file_index_;       ///< Index of the current file
+  G4int file_first_evt_;   ///< Events processed before the current file
+  G4int file_saved_;       ///< Events saved before the current file
+  G4int file_interacting_; ///< Interacting events before the current file
+  std::map<G4String, G4long> file_sink_photons_; ///< Killed before the current file
+
   G4int thr_charge_;
   G4double tof_time_;
   G4bool sns_only_;
   G4bool save_tot_charge_;
   G4bool sipm_cells_;
   HDF5Writer *h5writer_; ///< Event writer to hdf5 file
+  EventRowBuffer event_rows_; ///< Rows of the event being stored
 
   G4double bin_size_, tof_bin_size_, wire_bin_size_;
 };
@@ -106,6 +191,10 @@ inline void PetaloPersistencyManager::StoreSteps(G4bool ss)
 {
   store_steps_ = ss;
 }
+inline void PetaloPersistencyManager::SetStepSource(PetSaveAllSteppingAction* sa)
+{
+  step_source_ = sa;
+}
 inline void PetaloPersistencyManager::InteractingEvent(G4bool ie)
 {
   interacting_evt_ = ie;
@@ -118,6 +207,53 @@ inline void PetaloPersistencyManager::SetElectricField(G4double efield)
 {
   efield_ = efield;
 }
+inline void PetaloPersistencyManager::SetRunInfo(const G4String& key,
+                                                 const G4String& value)
+{
+  for (auto& entry : run_info_) {
+    if (entry.first == key) {
+      entry.second = value;
+      return;
+    }
+  }
+  run_info_.emplace_back(key, value);
+}
+inline void PetaloPersistencyManager::SetResume(G4bool resume)
+{
+  resume_ = resume;
+}
+inline G4int PetaloPersistencyManager::GetProcessedEvents() const
+{
+  return processed_evts_;
+}
+inline G4bool PetaloPersistencyManager::RollsOver() const
+{
+  return max_evts_file_ > 0 || max_bytes_file_ > 0;
+}
+inline const G4String& PetaloPersistencyManager::GetOutputFile() const
+{
+  return output_file_;
+}
+inline void PetaloPersistencyManager::SetOutputFile(const G4String& name)
+{
+  output_file_ = name;
+}
+inline G4int PetaloPersistencyManager::GetStartID() const
+{
+  return start_id_;
+}
+inline void PetaloPersistencyManager::SetStartID(G4int id)
+{
+  start_id_ = id;
+}
+inline void PetaloPersistencyManager::SetFirstEventIndex(G4int index)
+{
+  first_index_ = index;
+}
+inline G4int PetaloPersistencyManager::CurrentEventIndex() const
+{
+  return first_index_ + processed_evts_;
+}
 inline G4bool PetaloPersistencyManager::Store(const G4VPhysicalVolume *)
 {
   return false;
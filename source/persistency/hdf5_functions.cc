@@ -8,6 +8,8 @@
 
 #include "hdf5_functions.h"
 
+#include <cstring>
+
 hsize_t createRunType()
 {
   hid_t strtype = H5Tcopy(H5T_C_S1);
@@ -423,3 +425,87 @@ void writeChargeData(charge_data_t* chargeData, hid_t dataset, hid_t memtype,
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
+
+void setString(char* field, const char* value, size_t size)
+{
+  memset(field, 0, size);
+  strncpy(field, value, size - 1);
+}
+
+void writeBlock(const void* data, hid_t dataset, hid_t memtype,
+                hsize_t counter, hsize_t n_rows)
+{
+  if (n_rows == 0) return;
+
+  hid_t memspace, file_space;
+  //Create memspace for the new rows
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {n_rows};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  //Extend dataset
+  dims[0] = counter + n_rows;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {n_rows};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
+
+bool tableExists(hid_t file, const std::string& table_name)
+{
+  // Check every link of the path, since H5Lexists fails
+  // if an intermediate group does not exist
+  size_t pos = 0;
+  do {
+    pos = table_name.find('/', pos + 1);
+    std::string link = table_name.substr(0, pos);
+    if (H5Lexists(file, link.c_str(), H5P_DEFAULT) <= 0) return false;
+  } while (pos != std::string::npos);
+
+  return true;
+}
+
+hsize_t getTableSize(hid_t file, const std::string& table_name)
+{
+  if (!tableExists(file, table_name)) return 0;
+
+  hid_t dataset = H5Dopen2(file, table_name.c_str(), H5P_DEFAULT);
+  hid_t file_space = H5Dget_space(dataset);
+  hsize_t dims[1] = {0};
+  H5Sget_simple_extent_dims(file_space, dims, NULL);
+  H5Sclose(file_space);
+  H5Dclose(dataset);
+
+  return dims[0];
+}
+
+void readTable(hid_t file, const std::string& table_name, hsize_t memtype,
+               void* data)
+{
+  hid_t dataset = H5Dopen2(file, table_name.c_str(), H5P_DEFAULT);
+  H5Dread(dataset, memtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+  H5Dclose(dataset);
+}
+
+void readBlock(void* data, hid_t dataset, hid_t memtype,
+               hsize_t first, hsize_t n_rows)
+{
+  if (n_rows == 0) return;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {n_rows};
+  hid_t memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  hid_t file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {first};
+  hsize_t count[1] = {n_rows};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dread(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
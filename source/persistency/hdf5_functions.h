@@ -132,5 +132,23 @@ typedef struct{
   void writeChargeData(charge_data_t* chargeData, hid_t dataset, hid_t memtype,
                        hsize_t counter);
 
+  /// Copy a string to a fixed-size field, padded with zeros
+  void setString(char* field, const char* value, size_t size);
+
+  /// Write n_rows consecutive rows starting at row counter
+  void writeBlock(const void* data, hid_t dataset, hid_t memtype,
+                  hsize_t counter, hsize_t n_rows);
+
+  /// Whether the table and all the groups of its path exist
+  bool tableExists(hid_t file, const std::string& table_name);
+  /// Number of rows of a table (zero if it does not exist)
+  hsize_t getTableSize(hid_t file, const std::string& table_name);
+  /// Read all the rows of a table, data must hold getTableSize() rows
+  void readTable(hid_t file, const std::string& table_name, hsize_t memtype,
+                 void* data);
+  /// Read n_rows consecutive rows of an open dataset starting at row first
+  void readBlock(void* data, hid_t dataset, hid_t memtype,
+                 hsize_t first, hsize_t n_rows);
+
 
 #endif
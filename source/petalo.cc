@@ -6,28 +6,182 @@
 // The PETALO Collaboration
 // ----------------------------------------------------------------------------
 
+#include "PetaloPersistencyManager.h"
+#include "HDF5Merger.h"
+#include "PositronRangeTable.h"
+#include "PetaloUtils.h"
+#include "InitProfiler.h"
+
 #include "nexus/NexusApp.h"
 
 #include <G4UImanager.hh>
 #include <G4UIExecutive.hh>
 #include <G4VisExecutive.hh>
+#include <Randomize.hh>
 
 #include <getopt.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
 
 using namespace nexus;
 
 void PrintUsage()
 {
-  G4cerr  << "\nUsage: bin/petalo [-b|i] [-n number] <init_macro>\n" << G4endl;
+  G4cerr  << "\nUsage: bin/petalo [-b|i] [-n number] [-j number] [-r] [-p dir] <init_macro>\n" << G4endl;
   G4cerr  << "Available options:" << G4endl;
   G4cerr  << "   -b, --batch           : Run in batch mode (default)\n"
           << "   -i, --interactive     : Run in interactive mode\n"
-          << "   -n, --nevents         : Number of events to simulate"
+          << "   -n, --nevents         : Number of events to simulate\n"
+          << "   -j, --jobs            : Number of processes the events are split in\n"
+          << "   -r, --resume          : Continue the output file from its last checkpoint\n"
+          << "   -p, --physics-tables  : Directory where the physics tables are stored\n"
+          << "                           and read from in later runs"
           << G4endl;
   exit(EXIT_FAILURE);
 }
 
 
+// The physics tables in a directory are only used once they have been
+// completely written, which is marked by this file
+const G4String physics_tables_stamp = "physics_tables.stamp";
+
+G4bool PhysicsTablesStored(const G4String& dir)
+{
+  return std::filesystem::exists(std::filesystem::path(dir) / physics_tables_stamp);
+}
+
+
+// Store the physics tables, already built, in the given directory.
+// They are written to a temporary directory, which is renamed at the end,
+// so that other processes never read incomplete tables.
+void StorePhysicsTables(const G4String& dir)
+{
+  const G4String tmp_dir = dir + ".tmp." + std::to_string(getpid());
+  std::filesystem::create_directories(tmp_dir);
+
+  G4UImanager::GetUIpointer()->ApplyCommand("/run/particle/storePhysicsTable " + tmp_dir);
+  std::ofstream(std::filesystem::path(tmp_dir) / physics_tables_stamp) << "stored\n";
+
+  // Another process may have stored the tables in the meantime
+  std::error_code ec;
+  std::filesystem::rename(tmp_dir, dir, ec);
+  if (ec) std::filesystem::remove_all(tmp_dir);
+  else G4cout << "Physics tables stored in " << dir << G4endl;
+}
+
+
+// Split the run in several processes. They are forked after the empty
+// run of main(), which builds the geometry voxelization and the physics
+// tables, so that the processes share them. Each process simulates a
+// disjoint range of event IDs, with its own random seed and output file,
+// and the output files are merged at the end. This is the only parallel
+// mode: within a process, events run in a single thread.
+void RunJobs(NexusApp* app, G4int nevents, G4int njobs)
+{
+  PetaloPersistencyManager* pm = dynamic_cast<PetaloPersistencyManager*>
+    (G4VPersistencyManager::GetPersistencyManager());
+  if (!pm) {
+    G4Exception("[petalo]", "RunJobs()", FatalException,
+                "Splitting the run in several processes requires "
+                "the PetaloPersistencyManager.");
+  }
+
+  if (pm->RollsOver()) {
+    G4Exception("[petalo]", "RunJobs()", FatalException,
+                "Splitting the run in several processes cannot be combined "
+                "with the output file size limits.");
+  }
+
+  // The file opened during the initialization is replaced
+  // by one file per process
+  pm->CloseFile();
+
+  const G4String base_name = pm->GetOutputFile();
+  const G4int start_id     = pm->GetStartID();
+  const G4long seed        = CLHEP::HepRandom::getTheSeed();
+
+  // Each process writes its own positron range distributions,
+  // which are added at the end
+  G4UImanager* ui = G4UImanager::GetUIpointer();
+  const G4String range_cmd = "/PhysicsList/Petalo/tabulate_positron_range";
+  const G4String range_file = ui->GetCurrentValues(range_cmd);
+
+  G4cout << std::flush;
+  std::cout << std::flush;
+
+  std::vector<pid_t> pids;
+  std::vector<G4String> part_files;
+  G4int first_event = start_id;
+
+  for (G4int k=0; k<njobs; ++k) {
+    G4int share = nevents / njobs + (k < nevents % njobs ? 1 : 0);
+    G4String part_name = base_name + "." + std::to_string(k);
+    part_files.push_back(part_name + ".h5");
+    G4String range_part = range_file + "." + std::to_string(k);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+      G4Exception("[petalo]", "RunJobs()", FatalException,
+                  "Cannot create a new process.");
+    }
+
+    if (pid == 0) {
+      pm->SetOutputFile(part_name);
+      pm->SetStartID(first_event);
+      // Generators that follow the event sequence use the index
+      // of the event in the whole run
+      pm->SetFirstEventIndex(first_event - start_id);
+      if (range_file != "") ui->ApplyCommand(range_cmd + " " + range_part);
+      SeedEngine(seed, k);
+      pm->OpenFile();
+      app->BeamOn(share);
+      delete app;
+      exit(EXIT_SUCCESS);
+    }
+
+    pids.push_back(pid);
+    first_event += share;
+  }
+
+  G4bool success = true;
+  for (auto pid : pids) {
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      success = false;
+  }
+
+  if (!success) {
+    G4Exception("[petalo]", "RunJobs()", FatalException,
+                "At least one of the processes failed, "
+                "the output files are not merged.");
+  }
+
+  HDF5Merger merger;
+  merger.Merge(std::vector<std::string>(part_files.begin(), part_files.end()),
+               base_name + ".h5");
+  for (const auto& part : part_files) std::remove(part.c_str());
+
+  if (range_file != "") {
+    PositronRangeTable range_table;
+    for (G4int k=0; k<njobs; ++k) {
+      G4String range_part = range_file + "." + std::to_string(k);
+      if (!std::filesystem::exists(range_part)) continue;
+      range_table.Merge(range_part);
+      std::remove(range_part.c_str());
+    }
+    if (!range_table.IsEmpty()) range_table.Write(range_file);
+  }
+}
+
+
 G4int main(int argc, char** argv)
 {
   ////////////////////////////////////////////////////////////////////
@@ -39,12 +193,18 @@ G4int main(int argc, char** argv)
 
   G4bool batch = true;
   G4int nevents = 0;
+  G4int njobs = 1;
+  G4bool resume = false;
+  G4String tables_dir = "";
 
   static struct option long_options[] =
   {
     {"batch",       no_argument,       0, 'b'},
     {"interactive", no_argument,       0, 'i'},
     {"nevents",       required_argument, 0, 'n'},
+    {"jobs",          required_argument, 0, 'j'},
+    {"resume",        no_argument,       0, 'r'},
+    {"physics-tables", required_argument, 0, 'p'},
     {0, 0, 0, 0}
   };
 
@@ -54,7 +214,7 @@ G4int main(int argc, char** argv)
 
     //  int option_index = 0;
     opterr = 0;
-    c = getopt_long(argc, argv, "bin:", long_options, 0);
+    c = getopt_long(argc, argv, "bin:j:rp:", long_options, 0);
 
     if (c==-1) break; // Exit if we are done reading options
 
@@ -72,6 +232,19 @@ G4int main(int argc, char** argv)
         nevents = atoi(optarg);
         break;
 
+      case 'j':
+        njobs = atoi(optarg);
+        if (njobs < 1) PrintUsage();
+        break;
+
+      case 'r':
+        resume = true;
+        break;
+
+      case 'p':
+        tables_dir = optarg;
+        break;
+
       case '?':
         break;
 
@@ -99,8 +272,55 @@ G4int main(int argc, char** argv)
   ////////////////////////////////////////////////////////////////////
 
 
+  // Resuming a run split in several processes is not supported
+  if (resume && njobs > 1) PrintUsage();
+
   NexusApp* app = new NexusApp(macro_filename);
-  app->Initialize();
+
+  // The output file is opened during the initialization, so it must
+  // be known before whether it is continued from a checkpoint
+  PetaloPersistencyManager* pm = dynamic_cast<PetaloPersistencyManager*>
+    (G4VPersistencyManager::GetPersistencyManager());
+  if (resume) {
+    if (!pm) {
+      G4Exception("[petalo]", "main()", FatalException,
+                  "Resuming a run requires the PetaloPersistencyManager.");
+    }
+    pm->SetResume(true);
+  }
+
+  // Stored physics tables are read instead of being built
+  G4bool store_tables = false;
+  if (tables_dir != "") {
+    if (PhysicsTablesStored(tables_dir)) {
+      G4UImanager::GetUIpointer()->ApplyCommand("/run/particle/retrievePhysicsTable "
+                                                + tables_dir);
+      G4cout << "Physics tables read from " << tables_dir << G4endl;
+    }
+    else {
+      store_tables = true;
+    }
+  }
+
+  {
+    InitProfiler::Scope profile("NexusApp::Initialize");
+    app->Initialize();
+  }
+
+  // The geometry voxelization and the physics tables are otherwise built
+  // at the start of the first run. They are built here to be timed,
+  // before the physics tables are stored or the run is split in processes.
+  {
+    InitProfiler::Scope profile("G4RunManager::RunInitialization");
+    app->BeamOn(0);
+  }
+  InitProfiler::Instance().Print();
+  InitProfiler::Instance().SaveRunInfo();
+
+  if (store_tables) StorePhysicsTables(tables_dir);
+
+  // Only the events missing after the checkpoint are simulated
+  if (resume) nevents = std::max(nevents - pm->GetProcessedEvents(), 0);
 
   G4UImanager* UI = G4UImanager::GetUIpointer();
 
@@ -118,6 +338,9 @@ G4int main(int argc, char** argv)
     UI->ApplyCommand("/control/execute macros/vis.mac");
     ui->SessionStart();
   }
+  else if (njobs > 1) {
+    RunJobs(app, nevents, njobs);
+  }
   else {
     app->BeamOn(nevents);
   }
@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------
+// petalosim | OpticalRussianRoulette.cc
+//
+// This class implements a Russian roulette for optical photons.
+// After a given number of boundary interactions (reflections and
+// refractions), or beyond a given path length, photons survive with
+// probability p and their weight is multiplied by 1/p, so that the
+// expected detected charge is preserved while long photon histories
+// are truncated.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalRussianRoulette.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4Track.hh>
+#include <G4Step.hh>
+#include <Randomize.hh>
+
+
+OpticalRussianRoulette::OpticalRussianRoulette(const G4String& name):
+  G4VDiscreteProcess(name, fGeneral),
+  max_boundaries_(0), max_length_(0.), survival_prob_(1.),
+  n_boundaries_(0), next_length_(0.)
+{
+}
+
+
+OpticalRussianRoulette::~OpticalRussianRoulette()
+{
+}
+
+
+G4bool OpticalRussianRoulette::IsApplicable(const G4ParticleDefinition& p)
+{
+  return (&p == G4OpticalPhoton::Definition());
+}
+
+
+void OpticalRussianRoulette::StartTracking(G4Track* track)
+{
+  G4VDiscreteProcess::StartTracking(track);
+  n_boundaries_ = 0;
+  next_length_  = max_length_;
+}
+
+
+G4double OpticalRussianRoulette::PostStepGetPhysicalInteractionLength(const G4Track&,
+                                                                      G4double,
+                                                                      G4ForceCondition* condition)
+{
+  *condition = StronglyForced;
+  return DBL_MAX;
+}
+
+
+G4double OpticalRussianRoulette::GetMeanFreePath(const G4Track&, G4double,
+                                                 G4ForceCondition*)
+{
+  return DBL_MAX;
+}
+
+
+G4VParticleChange* OpticalRussianRoulette::PostStepDoIt(const G4Track& track,
+                                                        const G4Step& step)
+{
+  aParticleChange.Initialize(track);
+
+  if (track.GetTrackStatus() != fAlive)
+    return &aParticleChange;
+
+  G4bool roulette = false;
+
+  if (max_boundaries_ > 0 &&
+      step.GetPostStepPoint()->GetStepStatus() == fGeomBoundary) {
+    n_boundaries_++;
+    if (n_boundaries_ >= max_boundaries_) {
+      n_boundaries_ = 0;
+      roulette = true;
+    }
+  }
+
+  if (max_length_ > 0. && track.GetTrackLength() > next_length_) {
+    next_length_ += max_length_;
+    roulette = true;
+  }
+
+  if (roulette) {
+    if (G4UniformRand() < survival_prob_) {
+      aParticleChange.ProposeWeight(track.GetWeight() / survival_prob_);
+    } else {
+      aParticleChange.ProposeTrackStatus(fStopAndKill);
+    }
+  }
+
+  return &aParticleChange;
+}
@@ -0,0 +1,64 @@
+// ----------------------------------------------------------------------------
+// petalosim | OpticalRussianRoulette.h
+//
+// This class implements a Russian roulette for optical photons.
+// After a given number of boundary interactions (reflections and
+// refractions), or beyond a given path length, photons survive with
+// probability p and their weight is multiplied by 1/p, so that the
+// expected detected charge is preserved while long photon histories
+// are truncated.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_RUSSIAN_ROULETTE_H
+#define OPTICAL_RUSSIAN_ROULETTE_H
+
+#include <G4VDiscreteProcess.hh>
+
+class OpticalRussianRoulette : public G4VDiscreteProcess
+{
+public:
+  /// Constructor
+  OpticalRussianRoulette(const G4String& name = "OpRussianRoulette");
+  /// Destructor
+  ~OpticalRussianRoulette();
+
+  G4bool IsApplicable(const G4ParticleDefinition&) override;
+
+  /// Reset the counters of the photon
+  void StartTracking(G4Track*) override;
+
+  /// The roulette is evaluated at every step
+  G4double PostStepGetPhysicalInteractionLength(const G4Track&, G4double,
+                                                G4ForceCondition*) override;
+
+  G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&) override;
+
+  /// Number of boundary interactions between roulettes (zero means none)
+  void SetBoundaryInteractions(G4int);
+  /// Path length between roulettes (zero means none)
+  void SetPathLength(G4double);
+  /// Probability of surviving each roulette
+  void SetSurvivalProbability(G4double);
+
+protected:
+  G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*) override;
+
+private:
+  G4int max_boundaries_;
+  G4double max_length_;
+  G4double survival_prob_;
+
+  G4int n_boundaries_;   ///< Boundary interactions since the last roulette
+  G4double next_length_; ///< Path length of the next roulette
+};
+
+inline void OpticalRussianRoulette::SetBoundaryInteractions(G4int n)
+{ max_boundaries_ = n; }
+inline void OpticalRussianRoulette::SetPathLength(G4double length)
+{ max_length_ = length; }
+inline void OpticalRussianRoulette::SetSurvivalProbability(G4double p)
+{ survival_prob_ = p; }
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "PositronAnnihilation.h"
 #include "PetaloUtils.h"
+#include "PositronRangeTable.h"
 
 #include <G4UnitsTable.hh>
 #include <globals.hh>
@@ -19,6 +20,8 @@
 #include <G4Electron.hh>
 #include <G4Positron.hh>
 #include <G4eeToTwoGammaModel.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
 
 PositronAnnihilation::PositronAnnihilation(const G4String& name)
   :  G4VEmProcess(name)
@@ -72,6 +75,8 @@ G4VParticleChange* PositronAnnihilation::AtRestDoIt(const G4Track& aTrack,
 {
    fParticleChange.InitializeForPostStep(aTrack);
 
+   if (range_table_) FillRangeTable(aTrack);
+
    fParticleChange.SetNumberOfSecondaries(2) ;
 
    auto  dir1          = G4RandomDirection();
@@ -90,3 +95,26 @@ G4VParticleChange* PositronAnnihilation::AtRestDoIt(const G4Track& aTrack,
    return &fParticleChange;
 
 }
+
+
+G4VParticleChange* PositronAnnihilation::PostStepDoIt(const G4Track& aTrack,
+                                                      const G4Step& aStep)
+{
+  // Annihilation in flight is also recorded when tabulating the range
+  G4VParticleChange* change = G4VEmProcess::PostStepDoIt(aTrack, aStep);
+
+  if (range_table_ && change->GetTrackStatus() == fStopAndKill)
+    FillRangeTable(aTrack);
+
+  return change;
+}
+
+
+void PositronAnnihilation::FillRangeTable(const G4Track& aTrack)
+{
+  const G4String& material =
+    aTrack.GetLogicalVolumeAtVertex()->GetMaterial()->GetName();
+  G4double distance = (aTrack.GetPosition() - aTrack.GetVertexPosition()).mag();
+
+  range_table_->Fill(material, distance);
+}
@@ -13,6 +13,7 @@
 #include <G4VEmProcess.hh>
 
 class G4ParticleDefinition;
+class PositronRangeTable;
 
 class PositronAnnihilation : public G4VEmProcess
 
@@ -31,6 +32,13 @@ class PositronAnnihilation : public G4VEmProcess
                                               G4ForceCondition* condition
                                                ) override;
 
+  G4VParticleChange* PostStepDoIt(const G4Track& aTrack,
+                                  const G4Step& aStep) override;
+
+  /// Table where the distance travelled by each positron
+  /// before annihilating is recorded (none by default)
+  void SetRangeTable(PositronRangeTable* table);
+
   PositronAnnihilation & operator=(const PositronAnnihilation &right) = delete;
   PositronAnnihilation(const PositronAnnihilation&) = delete;
 
@@ -40,7 +48,14 @@ class PositronAnnihilation : public G4VEmProcess
 
   private:
 
+  void FillRangeTable(const G4Track& aTrack);
+
   G4bool isInitialised = false;
+
+  PositronRangeTable* range_table_ = nullptr;
 };
 
+inline void PositronAnnihilation::SetRangeTable(PositronRangeTable* table)
+{ range_table_ = table; }
+
 #endif
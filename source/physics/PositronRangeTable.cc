@@ -0,0 +1,176 @@
+// ----------------------------------------------------------------------------
+// petalosim | PositronRangeTable.cc
+//
+// This class holds, for each material, the distribution of the distance
+// between the creation and the annihilation points of positrons.
+// The distributions can be filled from full positron tracking and written
+// to a text file, which is later read to sample the annihilation point
+// without tracking the positron.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PositronRangeTable.h"
+
+#include <G4RandomDirection.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+
+PositronRangeTable::PositronRangeTable(G4double bin_width, G4int n_bins):
+  bin_width_(bin_width), n_bins_(n_bins)
+{
+}
+
+
+PositronRangeTable::~PositronRangeTable()
+{
+}
+
+
+void PositronRangeTable::Fill(const G4String& material, G4double distance)
+{
+  auto& counts = counts_[material];
+  if (counts.empty()) counts.resize(n_bins_, 0.);
+
+  G4int bin = std::min(G4int(distance/bin_width_), n_bins_ - 1);
+  counts[bin] += 1.;
+}
+
+
+void PositronRangeTable::Write(const G4String& filename) const
+{
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    G4Exception("[PositronRangeTable]", "Write()", FatalException,
+                ("Cannot open file " + filename).c_str());
+  }
+
+  file << "# material bin_width(mm) n_bins counts" << std::endl;
+  for (const auto& [material, counts] : counts_) {
+    file << material << " " << bin_width_/mm << " " << n_bins_;
+    for (auto c : counts) file << " " << c;
+    file << std::endl;
+  }
+}
+
+
+void PositronRangeTable::Read(const G4String& filename)
+{
+  counts_ = ReadCounts(filename);
+  cdf_.clear();
+
+  for (const auto& [material, counts] : counts_) {
+    std::vector<G4double> cdf(n_bins_, 0.);
+    std::partial_sum(counts.begin(), counts.end(), cdf.begin());
+    if (cdf.back() <= 0.) {
+      G4Exception("[PositronRangeTable]", "Read()", FatalException,
+                  ("Empty distribution for material " + material).c_str());
+    }
+    for (auto& c : cdf) c /= cdf.back();
+    cdf_[material] = cdf;
+  }
+}
+
+
+void PositronRangeTable::Merge(const G4String& filename)
+{
+  G4double bin_width = bin_width_;
+  G4int n_bins       = n_bins_;
+  G4bool empty       = IsEmpty();
+
+  auto counts = ReadCounts(filename);
+  if (counts.empty()) return;
+  if (!empty && (bin_width_ != bin_width || n_bins_ != n_bins)) {
+    G4Exception("[PositronRangeTable]", "Merge()", FatalException,
+                ("Different binning in " + filename).c_str());
+  }
+
+  for (const auto& [material, c] : counts) {
+    auto& total = counts_[material];
+    if (total.empty()) total.resize(n_bins_, 0.);
+    for (G4int i=0; i<n_bins_; ++i) total[i] += c[i];
+  }
+}
+
+
+G4bool PositronRangeTable::IsEmpty() const
+{
+  return counts_.empty();
+}
+
+
+std::map<G4String, std::vector<G4double>>
+PositronRangeTable::ReadCounts(const G4String& filename)
+{
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    G4Exception("[PositronRangeTable]", "Read()", FatalException,
+                ("Cannot open file " + filename).c_str());
+  }
+
+  std::map<G4String, std::vector<G4double>> all_counts;
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream iss(line);
+    G4String material;
+    G4double bin_width;
+    G4int n_bins;
+    iss >> material >> bin_width >> n_bins;
+
+    if (!all_counts.empty() && (bin_width*mm != bin_width_ || n_bins != n_bins_)) {
+      G4Exception("[PositronRangeTable]", "Read()", FatalException,
+                  "All materials must share the same binning.");
+    }
+    bin_width_ = bin_width * mm;
+    n_bins_    = n_bins;
+
+    std::vector<G4double> counts(n_bins_, 0.);
+    for (auto& c : counts) iss >> c;
+    if (iss.fail()) {
+      G4Exception("[PositronRangeTable]", "Read()", FatalException,
+                  ("Wrong format in the distribution of " + material).c_str());
+    }
+
+    all_counts[material] = counts;
+  }
+
+  return all_counts;
+}
+
+
+G4bool PositronRangeTable::HasMaterial(const G4String& material) const
+{
+  return cdf_.find(material) != cdf_.end();
+}
+
+
+G4double PositronRangeTable::SampleDistance(const G4String& material) const
+{
+  auto it = cdf_.find(material);
+  if (it == cdf_.end()) {
+    G4Exception("[PositronRangeTable]", "SampleDistance()", FatalException,
+                ("No positron range distribution for material " +
+                 material).c_str());
+  }
+
+  const auto& cdf = it->second;
+  G4int bin = std::upper_bound(cdf.begin(), cdf.end(), G4UniformRand()) -
+              cdf.begin();
+  bin = std::min(bin, n_bins_ - 1);
+
+  return (bin + G4UniformRand()) * bin_width_;
+}
+
+
+G4ThreeVector PositronRangeTable::SampleDisplacement(const G4String& material) const
+{
+  return SampleDistance(material) * G4RandomDirection();
+}
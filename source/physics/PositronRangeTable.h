@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------------
+// petalosim | PositronRangeTable.h
+//
+// This class holds, for each material, the distribution of the distance
+// between the creation and the annihilation points of positrons.
+// The distributions can be filled from full positron tracking and written
+// to a text file, which is later read to sample the annihilation point
+// without tracking the positron.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef POSITRON_RANGE_TABLE_H
+#define POSITRON_RANGE_TABLE_H
+
+#include <G4String.hh>
+#include <G4ThreeVector.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <map>
+#include <vector>
+
+class PositronRangeTable
+{
+public:
+  /// Constructor
+  PositronRangeTable(G4double bin_width = 0.01*mm, G4int n_bins = 3000);
+  /// Destructor
+  ~PositronRangeTable();
+
+  /// Add the distance travelled by a positron in a given material
+  void Fill(const G4String& material, G4double distance);
+
+  /// Write the distributions to a text file
+  void Write(const G4String& filename) const;
+  /// Read the distributions from a text file
+  void Read(const G4String& filename);
+  /// Add the counts of the distributions written to a text file,
+  /// such as those filled by other processes of the same run
+  void Merge(const G4String& filename);
+
+  /// Return true if no distance has been added
+  G4bool IsEmpty() const;
+
+  /// Return true if there is a distribution for the given material
+  G4bool HasMaterial(const G4String& material) const;
+
+  /// Sample a distance from the distribution of the given material
+  G4double SampleDistance(const G4String& material) const;
+  /// Sample an isotropic displacement from the distribution
+  /// of the given material
+  G4ThreeVector SampleDisplacement(const G4String& material) const;
+
+private:
+  /// Read the counts of each material from a text file
+  std::map<G4String, std::vector<G4double>> ReadCounts(const G4String& filename);
+
+  G4double bin_width_;
+  G4int n_bins_;
+
+  /// Counts per distance bin, the last one includes the overflow
+  std::map<G4String, std::vector<G4double>> counts_;
+  /// Normalised cumulative distributions used for sampling
+  std::map<G4String, std::vector<G4double>> cdf_;
+};
+
+#endif
@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+// petalosim | TabulatedNESTcalc.cc
+//
+// NEST calculator that tabulates the mean yields of each interaction type
+// as a function of the deposited energy, for a given density and electric
+// field, and interpolates them instead of evaluating the NEST models at
+// every energy deposit. The fluctuations are still computed by NEST from
+// the interpolated yields. The interpolation is checked against the direct
+// calculation when each table is built.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "TabulatedNESTcalc.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+
+TabulatedNESTcalc::TabulatedNESTcalc(VDetector* detector, G4int n_nodes,
+                                     G4double tolerance):
+  NEST::NESTcalc(detector), n_nodes_(n_nodes), tolerance_(tolerance),
+  log_e_min_(-1.), log_e_max_(std::log10(2000.))
+{
+  if (n_nodes_ < 2) {
+    G4Exception("[TabulatedNESTcalc]", "TabulatedNESTcalc()", FatalException,
+                "At least two energy nodes are needed.");
+  }
+}
+
+
+TabulatedNESTcalc::~TabulatedNESTcalc()
+{
+}
+
+
+NEST::YieldResult
+TabulatedNESTcalc::GetYields(NEST::INTERACTION_TYPE species, double energy,
+                             double density, double dfield,
+                             double A, double Z,
+                             const std::vector<double>& NuisParam,
+                             const std::vector<double>& ERYieldsParam,
+                             bool oldModelER)
+{
+  // Only the interaction types whose yields depend on energy alone
+  // (for fixed density and field) and the default parameters are tabulated
+  G4bool tabulated =
+    (species == NEST::beta || species == NEST::gammaRay || species == NEST::NR) &&
+    NuisParam == default_NuisParam && ERYieldsParam == default_ERYieldsParam &&
+    !oldModelER;
+
+  G4double log_e = energy > 0. ? std::log10(energy) : log_e_min_ - 1.;
+
+  if (!tabulated || log_e < log_e_min_ || log_e >= log_e_max_)
+    return NEST::NESTcalc::GetYields(species, energy, density, dfield, A, Z,
+                                     NuisParam, ERYieldsParam, oldModelER);
+
+  return Interpolate(GetTable(species, density, dfield), energy);
+}
+
+
+const std::vector<NEST::YieldResult>&
+TabulatedNESTcalc::GetTable(NEST::INTERACTION_TYPE species,
+                            G4double density, G4double dfield)
+{
+  TableKey key(species, density, dfield);
+
+  auto it = tables_.find(key);
+  if (it == tables_.end())
+    it = tables_.emplace(key, BuildTable(species, density, dfield)).first;
+
+  return it->second;
+}
+
+
+std::vector<NEST::YieldResult>
+TabulatedNESTcalc::BuildTable(NEST::INTERACTION_TYPE species,
+                              G4double density, G4double dfield)
+{
+  // Xenon is the only target for the tabulated interaction types
+  const G4double A = 131.293;
+  const G4double Z = 54.;
+
+  std::vector<NEST::YieldResult> table;
+  table.reserve(n_nodes_);
+  for (G4int i=0; i<n_nodes_; ++i) {
+    table.push_back(NEST::NESTcalc::GetYields(species, NodeEnergy(i),
+                                              density, dfield, A, Z));
+  }
+
+  // Compare the interpolation with NEST halfway between nodes
+  G4double max_dev = 0.;
+  G4double max_dev_energy = 0.;
+  for (G4int i=0; i<n_nodes_-1; ++i) {
+    G4double energy = 0.5 * (NodeEnergy(i) + NodeEnergy(i+1));
+    NEST::YieldResult direct =
+      NEST::NESTcalc::GetYields(species, energy, density, dfield, A, Z);
+    NEST::YieldResult interp = Interpolate(table, energy);
+
+    // Deviations below one quantum are not relevant
+    G4double dev_ph = std::abs(interp.PhotonYield - direct.PhotonYield) /
+      std::max(direct.PhotonYield, 1.);
+    G4double dev_el = std::abs(interp.ElectronYield - direct.ElectronYield) /
+      std::max(direct.ElectronYield, 1.);
+
+    if (std::max(dev_ph, dev_el) > max_dev) {
+      max_dev = std::max(dev_ph, dev_el);
+      max_dev_energy = energy;
+    }
+  }
+
+  G4cout << "[TabulatedNESTcalc] NEST yields tabulated for interaction type "
+         << species << ", density " << density << " g/cm3 and field "
+         << dfield << " V/cm. Maximum relative deviation: " << max_dev
+         << " at " << max_dev_energy << " keV." << G4endl;
+
+  if (max_dev > tolerance_) {
+    std::ostringstream msg;
+    msg << "The interpolation of the NEST yields deviates by " << max_dev
+        << " at " << max_dev_energy << " keV, above the tolerance "
+        << tolerance_ << ". Consider increasing the number of nodes.";
+    G4Exception("[TabulatedNESTcalc]", "BuildTable()", JustWarning,
+                msg.str().c_str());
+  }
+
+  return table;
+}
+
+
+NEST::YieldResult
+TabulatedNESTcalc::Interpolate(const std::vector<NEST::YieldResult>& table,
+                               G4double energy) const
+{
+  G4double x = (std::log10(energy) - log_e_min_) / (log_e_max_ - log_e_min_) *
+    (n_nodes_ - 1);
+  G4int i = std::min(G4int(x), n_nodes_ - 2);
+
+  // Yields are close to linear in energy between neighbouring nodes
+  G4double e_low  = NodeEnergy(i);
+  G4double e_high = NodeEnergy(i+1);
+  G4double f = (energy - e_low) / (e_high - e_low);
+
+  const NEST::YieldResult& low  = table[i];
+  const NEST::YieldResult& high = table[i+1];
+
+  NEST::YieldResult result = low;
+  result.PhotonYield   = low.PhotonYield   + f * (high.PhotonYield   - low.PhotonYield);
+  result.ElectronYield = low.ElectronYield + f * (high.ElectronYield - low.ElectronYield);
+  result.ExcitonRatio  = low.ExcitonRatio  + f * (high.ExcitonRatio  - low.ExcitonRatio);
+  result.Lindhard      = low.Lindhard      + f * (high.Lindhard      - low.Lindhard);
+  result.DeltaT_Scint  = low.DeltaT_Scint  + f * (high.DeltaT_Scint  - low.DeltaT_Scint);
+
+  return result;
+}
+
+
+G4double TabulatedNESTcalc::NodeEnergy(G4int node) const
+{
+  return std::pow(10., log_e_min_ + (log_e_max_ - log_e_min_) * node / (n_nodes_ - 1));
+}
@@ -0,0 +1,67 @@
+// ----------------------------------------------------------------------------
+// petalosim | TabulatedNESTcalc.h
+//
+// NEST calculator that tabulates the mean yields of each interaction type
+// as a function of the deposited energy, for a given density and electric
+// field, and interpolates them instead of evaluating the NEST models at
+// every energy deposit. The fluctuations are still computed by NEST from
+// the interpolated yields. The interpolation is checked against the direct
+// calculation when each table is built.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef TABULATED_NEST_CALC_H
+#define TABULATED_NEST_CALC_H
+
+#include <NEST.hh>
+
+#include <globals.hh>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+class TabulatedNESTcalc : public NEST::NESTcalc
+{
+public:
+  /// Constructor, with the number of energy nodes of each table
+  /// and the maximum relative deviation allowed in the accuracy check
+  TabulatedNESTcalc(VDetector* detector, G4int n_nodes, G4double tolerance);
+  /// Destructor
+  ~TabulatedNESTcalc();
+
+  /// Return the interpolated yields for the tabulated interaction types,
+  /// or the NEST calculation otherwise
+  NEST::YieldResult GetYields(NEST::INTERACTION_TYPE species, double energy,
+                              double density, double dfield,
+                              double A, double Z,
+                              const std::vector<double>& NuisParam = default_NuisParam,
+                              const std::vector<double>& ERYieldsParam = default_ERYieldsParam,
+                              bool oldModelER = false) override;
+
+private:
+  typedef std::tuple<G4int, G4double, G4double> TableKey;
+
+  /// Return the table of a given interaction type, density and field,
+  /// which is built the first time it is needed
+  const std::vector<NEST::YieldResult>& GetTable(NEST::INTERACTION_TYPE species,
+                                                 G4double density,
+                                                 G4double dfield);
+  /// Tabulate the yields and compare the interpolation with NEST
+  std::vector<NEST::YieldResult> BuildTable(NEST::INTERACTION_TYPE species,
+                                            G4double density, G4double dfield);
+
+  NEST::YieldResult Interpolate(const std::vector<NEST::YieldResult>& table,
+                                G4double energy) const;
+  /// Energy of a given node of the tables (in keV)
+  G4double NodeEnergy(G4int node) const;
+
+  G4int n_nodes_;
+  G4double tolerance_;
+  G4double log_e_min_, log_e_max_; ///< Energy range (log10 of keV)
+
+  std::map<TableKey, std::vector<NEST::YieldResult>> tables_;
+};
+
+#endif
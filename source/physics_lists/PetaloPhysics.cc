@@ -8,7 +8,11 @@
 
 #include "PetaloPhysics.h"
 #include "PositronAnnihilation.h"
+#include "PositronRangeTable.h"
+#include "TabulatedNESTcalc.h"
+#include "OpticalRussianRoulette.h"
 #include "PetaloPersistencyManager.h"
+#include "InitProfiler.h"
 
 #include <NESTProc.hh>
 #include <VDetector.hh>
@@ -34,7 +38,13 @@ G4_DECLARE_PHYSCONSTR_FACTORY(PetaloPhysics);
 PetaloPhysics::PetaloPhysics() : G4VPhysicsConstructor("PetaloPhysics"),
                                  risetime_(false), noCompt_(false),
                                  nest_(false), prod_th_el_(false),
-                                 petalo_detector_("FullRing")
+                                 nest_table_(false), nest_table_nodes_(400),
+                                 nest_table_tol_(0.01),
+                                 petalo_detector_("FullRing"),
+                                 roulette_(false), roulette_boundaries_(20),
+                                 roulette_length_(0.), roulette_survival_(0.5),
+                                 pos_range_file_(""), pos_range_table_(nullptr),
+                                 roulette_proc_(nullptr)
 {
   msg_ = new G4GenericMessenger(this, "/PhysicsList/Petalo/",
                                 "Control commands of the nexus physics list.");
@@ -51,15 +61,67 @@ PetaloPhysics::PetaloPhysics() : G4VPhysicsConstructor("PetaloPhysics"),
   msg_->DeclareProperty("thermal_electrons", prod_th_el_,
                         "If true, NEST thermal electrons are produced.");
 
+  msg_->DeclareProperty("nest_yield_table", nest_table_,
+                        "If true, NEST yields are tabulated and interpolated.");
+
+  G4GenericMessenger::Command& nodes_cmd =
+    msg_->DeclareProperty("nest_table_nodes", nest_table_nodes_,
+                          "Number of energy nodes of the NEST yield tables.");
+  nodes_cmd.SetParameterName("nest_table_nodes", false);
+  nodes_cmd.SetRange("nest_table_nodes>1");
+
+  G4GenericMessenger::Command& tol_cmd =
+    msg_->DeclareProperty("nest_table_tolerance", nest_table_tol_,
+                          "Maximum relative deviation of the NEST yield tables "
+                          "from the direct calculation.");
+  tol_cmd.SetParameterName("nest_table_tolerance", false);
+  tol_cmd.SetRange("nest_table_tolerance>0.");
+
   msg_->DeclareProperty("petalo_detector", petalo_detector_,
                         "Detector geometry chosen.");
+
+  msg_->DeclareProperty("optical_roulette", roulette_,
+                        "If true, optical photons are subject to Russian roulette.");
+
+  G4GenericMessenger::Command& rr_bound_cmd =
+    msg_->DeclareProperty("roulette_boundaries", roulette_boundaries_,
+                          "Number of boundary interactions between roulettes "
+                          "(0 means none).");
+  rr_bound_cmd.SetParameterName("roulette_boundaries", false);
+  rr_bound_cmd.SetRange("roulette_boundaries>=0");
+
+  G4GenericMessenger::Command& rr_length_cmd =
+    msg_->DeclareProperty("roulette_length", roulette_length_,
+                          "Path length between roulettes (0 means none).");
+  rr_length_cmd.SetUnitCategory("Length");
+  rr_length_cmd.SetParameterName("roulette_length", false);
+  rr_length_cmd.SetRange("roulette_length>=0.");
+
+  G4GenericMessenger::Command& rr_surv_cmd =
+    msg_->DeclareProperty("roulette_survival", roulette_survival_,
+                          "Probability of surviving each roulette.");
+  rr_surv_cmd.SetParameterName("roulette_survival", false);
+  rr_surv_cmd.SetRange("roulette_survival>0. && roulette_survival<=1.");
+
+  msg_->DeclareProperty("tabulate_positron_range", pos_range_file_,
+                        "If set, the distance travelled by positrons "
+                        "in each material is written to this file.");
 }
 
 PetaloPhysics::~PetaloPhysics()
 {
+  // Processes that have not tracked any positron, such as the parent
+  // of a run split in several processes, do not overwrite the file
+  if (pos_range_table_) {
+    if (!pos_range_table_->IsEmpty())
+      pos_range_table_->Write(pos_range_file_);
+    delete pos_range_table_;
+  }
+
   delete msg_;
   delete wls_;
   delete pos_annihil_;
+  delete roulette_proc_;
 }
 
 void PetaloPhysics::ConstructParticle()
@@ -70,6 +132,8 @@ void PetaloPhysics::ConstructParticle()
 
 void PetaloPhysics::ConstructProcess()
 {
+  InitProfiler::Scope profile("PetaloPhysics::ConstructProcess");
+
   G4ProcessManager* pmanager = 0;
 
   // Add our own wavelength shifting process for the optical photon
@@ -83,6 +147,14 @@ void PetaloPhysics::ConstructProcess()
   wls_ = new nexus::WavelengthShifting();
   pmanager->AddDiscreteProcess(wls_);
 
+  if (roulette_) {
+    roulette_proc_ = new OpticalRussianRoulette();
+    roulette_proc_->SetBoundaryInteractions(roulette_boundaries_);
+    roulette_proc_->SetPathLength(roulette_length_);
+    roulette_proc_->SetSurvivalProbability(roulette_survival_);
+    pmanager->AddDiscreteProcess(roulette_proc_);
+  }
+
   pmanager = G4Positron::Definition()->GetProcessManager();
 
   // Remove Geant4 annihilation process
@@ -95,6 +167,11 @@ void PetaloPhysics::ConstructProcess()
   pmanager->AddDiscreteProcess(pos_annihil_);
   pmanager->SetProcessOrderingToFirst(pos_annihil_, idxAtRest);
 
+  if (pos_range_file_ != "") {
+    pos_range_table_ = new PositronRangeTable();
+    pos_annihil_->SetRangeTable(pos_range_table_);
+  }
+
   // Add rise time to scintillation
   if (risetime_)
   {
@@ -129,7 +206,9 @@ void PetaloPhysics::ConstructProcess()
     PetaloPersistencyManager* pm =
       dynamic_cast<PetaloPersistencyManager*>(G4VPersistencyManager::GetPersistencyManager());
     pm->SetElectricField(e_field);
-    NEST::NESTcalc* petaloCalc = new NEST::NESTcalc(petalo_);
+    NEST::NESTcalc* petaloCalc = nest_table_ ?
+      new TabulatedNESTcalc(petalo_, nest_table_nodes_, nest_table_tol_) :
+      new NEST::NESTcalc(petalo_);
     NEST::NESTProc* theNESTScintillationProcess =
       new NEST::NESTProc("S1", fElectromagnetic, petaloCalc, petalo_);
     theNESTScintillationProcess->SetDetailedSecondaries(true); // this is to use the full scintillation spectrum of LXe.
@@ -16,6 +16,8 @@
 
 class G4GenericMessenger;
 class PositronAnnihilation;
+class PositronRangeTable;
+class OpticalRussianRoulette;
 
 class PetaloPhysics : public G4VPhysicsConstructor
 {
@@ -41,13 +43,29 @@ private:
 
   G4bool prod_th_el_; ///< If true, NEST thermal electrons are produced
 
+  G4bool nest_table_; ///< If true, NEST yields are tabulated
+  G4int nest_table_nodes_; ///< Number of energy nodes of the NEST tables
+  G4double nest_table_tol_; ///< Accepted deviation of the NEST tables
+
   G4String petalo_detector_;
 
+  G4bool roulette_; ///< Switch on/off the Russian roulette of optical photons
+  G4int roulette_boundaries_; ///< Boundary interactions between roulettes
+  G4double roulette_length_; ///< Path length between roulettes
+  G4double roulette_survival_; ///< Survival probability in each roulette
+
+  /// File where the positron range distributions are written,
+  /// if they are tabulated in this run
+  G4String pos_range_file_;
+  PositronRangeTable* pos_range_table_;
+
   G4GenericMessenger* msg_;
 
   nexus::WavelengthShifting* wls_;
   
   PositronAnnihilation* pos_annihil_;
+
+  OpticalRussianRoulette* roulette_proc_;
 };
 
 #endif
@@ -11,11 +11,16 @@
 #include <NESTProc.hh>
 
 #include <G4SDManager.hh>
+#include <G4PhysicalConstants.hh>
+
+#include <cmath>
 
 using namespace CLHEP;
 
 ChargeSD::ChargeSD(G4String sdname) : G4VSensitiveDetector(sdname),
-                                      timebinning_(1.*microsecond)
+                                      timebinning_(1.*microsecond),
+                                      wire_radius_(0.), n_wires_(0),
+                                      wire_half_length_(0.)
 {
   // Register the name of the collection of hits
   collectionName.insert(GetCollectionUniqueName());
@@ -53,28 +58,54 @@ G4bool ChargeSD::ProcessHits(G4Step *step, G4TouchableHistory *)
 
   G4int sns_id = FindSensorID(touchable);
 
-  ChargeHit *hit = 0;
+  ChargeHit* hit = FindOrCreateHit(sns_id, touchable->GetTranslation());
+
+  G4double time = step->GetPostStepPoint()->GetGlobalTime();
+  hit->Fill(time);
+
+  return true;
+}
+
+void ChargeSD::AddCharge(const G4ThreeVector& position, G4double time)
+{
+  if (n_wires_ == 0) {
+    G4Exception("[ChargeSD]", "AddCharge()", FatalException,
+                "The ring of wires has not been defined.");
+  }
+
+  // Wire i is placed at an angle i*step from the y axis,
+  // in the same way as it is built in the geometry
+  G4double step  = twopi / n_wires_;
+  G4double angle = std::atan2(-position.x(), position.y());
+  if (angle < 0.) angle += twopi;
+
+  G4int sns_id = G4int(std::round(angle / step)) % n_wires_;
+
+  G4double wire_angle = sns_id * step;
+  G4ThreeVector wire_pos(-wire_radius_ * std::sin(wire_angle),
+                          wire_radius_ * std::cos(wire_angle), 0.);
+
+  ChargeHit* hit = FindOrCreateHit(sns_id, wire_pos);
+  hit->Fill(time);
+}
+
+ChargeHit* ChargeSD::FindOrCreateHit(G4int sns_id, const G4ThreeVector& position)
+{
   for (size_t i=0; i<HC_->entries(); i++) {
     if ((*HC_)[i]->GetSensorID() == sns_id) {
-      hit = (*HC_)[i];
-      break;
+      return (*HC_)[i];
     }
   }
 
   // If no hit associated to this sensor exists already,
   // create it and set main properties
-  if (!hit) {
-    hit = new ChargeHit();
-    hit->SetSensorID(sns_id);
-    hit->SetBinSize(timebinning_);
-    hit->SetPosition(touchable->GetTranslation());
-    HC_->insert(hit);
-  }
+  ChargeHit* hit = new ChargeHit();
+  hit->SetSensorID(sns_id);
+  hit->SetBinSize(timebinning_);
+  hit->SetPosition(position);
+  HC_->insert(hit);
 
-  G4double time = step->GetPostStepPoint()->GetGlobalTime();
-  hit->Fill(time);
-
-  return true;
+  return hit;
 }
 
 G4int ChargeSD::FindSensorID(const G4VTouchable* touchable)
@@ -37,6 +37,18 @@ public:
   /// Set a time binning for the hits
   void SetTimeBinning(G4double);
 
+  /// Describe the readout as a ring of wires parallel to the z axis,
+  /// centred at the origin. Needed to collect charge without tracking
+  /// the ionization electrons.
+  void SetWireRing(G4double radius, G4int n_wires, G4double half_length);
+  G4double GetWireRadius() const;
+  G4int GetNumberOfWires() const;
+  G4double GetWireHalfLength() const;
+
+  /// Add an ionization electron arriving at the wire ring
+  /// in a given position and time
+  void AddCharge(const G4ThreeVector& position, G4double time);
+
   /// Return the unique name of the hits collection created
   /// by this sensitive detector. This will be used by the
   /// persistency manager to select the collection.
@@ -47,13 +59,27 @@ public:
 
   G4int FindSensorID(const G4VTouchable*);
 
+  /// Return the hit of a sensor, creating it if needed
+  ChargeHit* FindOrCreateHit(G4int sns_id, const G4ThreeVector& position);
+
   ChargeHitsCollection *HC_; ///< Pointer to the collection of hits
 
   G4double timebinning_; ///< Time bin width
 
+  G4double wire_radius_; ///< Radius of the ring of wires
+  G4int n_wires_; ///< Number of wires in the ring
+  G4double wire_half_length_; ///< Half length of the wires
+
 };
 
 inline G4double ChargeSD::GetTimeBinning() const { return timebinning_; }
 inline void ChargeSD::SetTimeBinning(G4double tb) { timebinning_ = tb; }
 
+inline void ChargeSD::SetWireRing(G4double radius, G4int n_wires,
+                                  G4double half_length)
+{ wire_radius_ = radius; n_wires_ = n_wires; wire_half_length_ = half_length; }
+inline G4double ChargeSD::GetWireRadius() const { return wire_radius_; }
+inline G4int ChargeSD::GetNumberOfWires() const { return n_wires_; }
+inline G4double ChargeSD::GetWireHalfLength() const { return wire_half_length_; }
+
 #endif
@@ -14,14 +14,14 @@ G4Allocator<PetSensorHit> PetSensorHitAllocator;
 
 
 PetSensorHit::PetSensorHit():
-  G4VHit(), counts_(0), sns_id_(-1.)
+  G4VHit(), counts_(0), weighted_counts_(0.), sns_id_(-1.)
 {
 }
 
 
 
 PetSensorHit::PetSensorHit(G4int id, const G4ThreeVector& position):
-  G4VHit(), counts_(0), sns_id_(id), position_(position)
+  G4VHit(), counts_(0), weighted_counts_(0.), sns_id_(id), position_(position)
 {
 }
 
@@ -45,6 +45,7 @@ const PetSensorHit& PetSensorHit::operator=(const PetSensorHit& other)
   sns_id_    = other.sns_id_;
   position_  = other.position_;
   counts_    = other.counts_;
+  weighted_counts_ = other.weighted_counts_;
   phot_      = other.phot_;
 
   return *this;
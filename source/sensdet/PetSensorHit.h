@@ -51,10 +51,15 @@ public:
   void AddPhoton(G4double time, G4int track_id);
 
   G4int GetDetPhotons() const;
+  /// Returns the sum of the weights of the detected photons
+  G4double GetWeightedPhotons() const;
   const std::map<G4double, G4int>& GetPhotonMap() const;
 
   /// Number of detected photons
   G4int counts_;
+  /// Sum of the weights of the detected photons, equal to counts_
+  /// unless variance reduction is applied to optical photons
+  G4double weighted_counts_;
 
 private:
   G4int sns_id_;           ///< Detector ID number
@@ -85,6 +90,8 @@ inline void PetSensorHit::SetPosition(const G4ThreeVector& p) { position_ = p; }
 
 inline G4int PetSensorHit::GetDetPhotons() const
 { return counts_; }
+inline G4double PetSensorHit::GetWeightedPhotons() const
+{ return weighted_counts_; }
 inline const std::map<G4double, G4int>& PetSensorHit::GetPhotonMap() const
 { return phot_; }
 
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// petalosim | PhotonSinkSD.cc
+//
+// This class is a sensitive detector that kills the optical photons
+// entering the volumes it is attached to, counting them per volume.
+// It is meant for passive structures where the photons cannot be detected.
+// As any sensitive detector, it only sees the steps inside its volumes,
+// so a photon is killed at the end of its first step in the sink, not on
+// the boundary. Photons reflected by an optical surface of the sink never
+// enter it and are therefore not killed.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PhotonSinkSD.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4SDManager.hh>
+#include <G4Step.hh>
+#include <G4LogicalVolume.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4VPhysicalVolume.hh>
+
+
+PhotonSinkSD::PhotonSinkSD(G4String sdname) : G4VSensitiveDetector(sdname)
+{
+}
+
+PhotonSinkSD::~PhotonSinkSD()
+{
+}
+
+G4String PhotonSinkSD::GetSDName()
+{
+  return "/PHOTON_SINK";
+}
+
+G4bool PhotonSinkSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  G4Track* track = step->GetTrack();
+  if (track->GetDefinition() != G4OpticalPhoton::Definition())
+    return false;
+
+  // This is the first step of the photon in the sink
+  track->SetTrackStatus(fStopAndKill);
+
+  const G4String& volume =
+    step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetName();
+  killed_[volume]++;
+
+  return true;
+}
+
+void PhotonSinkSD::SetPhotonSinks(const std::vector<G4String>& volume_names)
+{
+  if (volume_names.empty()) return;
+
+  G4SDManager* sdmgr = G4SDManager::GetSDMpointer();
+  PhotonSinkSD* sinksd =
+    dynamic_cast<PhotonSinkSD*>(sdmgr->FindSensitiveDetector(GetSDName(), false));
+  if (!sinksd) {
+    sinksd = new PhotonSinkSD(GetSDName());
+    sdmgr->AddNewDetector(sinksd);
+  }
+
+  // Several logical volumes may share the same name
+  G4LogicalVolumeStore* lvstore = G4LogicalVolumeStore::GetInstance();
+  for (const auto& name : volume_names) {
+    G4bool found = false;
+    for (auto lv : *lvstore) {
+      if (lv->GetName() != name) continue;
+      found = true;
+      if (lv->GetSensitiveDetector() && lv->GetSensitiveDetector() != sinksd) {
+        G4Exception("[PhotonSinkSD]", "SetPhotonSinks()", JustWarning,
+                    ("Volume " + name + " is already sensitive, "
+                     "it is not turned into a photon sink.").c_str());
+        continue;
+      }
+      lv->SetSensitiveDetector(sinksd);
+    }
+    if (!found) {
+      G4Exception("[PhotonSinkSD]", "SetPhotonSinks()", FatalException,
+                  ("Photon sink volume " + name + " not found.").c_str());
+    }
+  }
+}
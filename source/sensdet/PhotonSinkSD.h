@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------------
+// petalosim | PhotonSinkSD.h
+//
+// This class is a sensitive detector that kills the optical photons
+// entering the volumes it is attached to, counting them per volume.
+// It is meant for passive structures where the photons cannot be detected.
+// As any sensitive detector, it only sees the steps inside its volumes,
+// so a photon is killed at the end of its first step in the sink, not on
+// the boundary. Photons reflected by an optical surface of the sink never
+// enter it and are therefore not killed.
+// The counts are those of the process: when a run is split in processes,
+// the merger of their output files adds them.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PHOTON_SINK_SD_H
+#define PHOTON_SINK_SD_H
+
+#include <G4VSensitiveDetector.hh>
+
+#include <map>
+#include <vector>
+
+class G4Step;
+class G4TouchableHistory;
+
+class PhotonSinkSD : public G4VSensitiveDetector
+{
+public:
+  /// Constructor
+  PhotonSinkSD(G4String sdname);
+  /// Destructor
+  ~PhotonSinkSD();
+
+  /// Return the number of optical photons killed in each logical volume
+  const std::map<G4String, G4int>& GetKilledPhotons() const;
+
+  /// Return the name of the sensitive detector used for all photon sinks
+  static G4String GetSDName();
+
+  /// Turn all the logical volumes with the given names into photon sinks,
+  /// creating the sensitive detector if needed
+  static void SetPhotonSinks(const std::vector<G4String>& volume_names);
+
+private:
+  G4bool ProcessHits(G4Step* step, G4TouchableHistory*);
+
+  std::map<G4String, G4int> killed_; ///< Killed photons per volume
+};
+
+inline const std::map<G4String, G4int>& PhotonSinkSD::GetKilledPhotons() const
+{ return killed_; }
+
+#endif
@@ -22,6 +22,7 @@ using namespace CLHEP;
 ToFSD::ToFSD(G4String sdname) : G4VSensitiveDetector(sdname),
                                 naming_order_(0), sensor_depth_(0),
                                 mother_depth_(0),
+                                replica_depth_(0), mothers_per_replica_(0),
                                 box_conf_(def), sipm_cells_(false)
 {
   // Register the name of the collection of hits
@@ -56,6 +57,13 @@ G4bool ToFSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   if (pdef != G4OpticalPhoton::Definition())
     return false;
 
+  // The optical boundary process is invoked even if a strongly forced
+  // process, such as the Russian roulette, has killed the photon earlier
+  // in the same step. Such photons must not be detected, otherwise the
+  // weight of the survivors would be added on top of theirs.
+  if (step->GetTrack()->GetTrackStatus() == fStopAndKill)
+    return false;
+
   const G4VTouchable* touchable =
     step->GetPostStepPoint()->GetTouchable();
 
@@ -82,6 +90,7 @@ G4bool ToFSD::ProcessHits(G4Step* step, G4TouchableHistory*)
     }
 
   hit->counts_ += 1;
+  hit->weighted_counts_ += step->GetTrack()->GetWeight();
   G4double time = step->GetPostStepPoint()->GetGlobalTime();
   hit->AddPhoton(time, step->GetTrack()->GetTrackID());
 
@@ -95,6 +104,8 @@ G4int ToFSD::FindID(const G4VTouchable* touchable)
   if (naming_order_ != 0)
   {
     G4int motherid = touchable->GetCopyNumber(mother_depth_);
+    if (mothers_per_replica_ != 0)
+      motherid += mothers_per_replica_ * touchable->GetCopyNumber(replica_depth_);
     snsid = naming_order_ * motherid + snsid;
   }
 
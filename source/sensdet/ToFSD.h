@@ -56,6 +56,11 @@ public:
   /// Return the depth of the SD's grandmother volume in the geometry hierarchy
   G4int GetGrandMotherVolumeDepth() const;
 
+  /// Set the depth of a replicated volume above the SD's mother and the
+  /// number of mothers it contains: its copy number times this number
+  /// is added to the ID of the mother
+  void SetReplicaVolumeDepth(G4int depth, G4int mothers_per_replica);
+
   /// Set the box geometry parameter
   void SetBoxConf(petit_conf);
 
@@ -67,15 +72,18 @@ public:
   /// persistency manager to select the collection.
   static G4String GetCollectionUniqueName();
 
+  /// Return the ID of the sensor at the top of the touchable
+  G4int FindID(const G4VTouchable *);
+
 private:
   G4bool ProcessHits(G4Step *, G4TouchableHistory *);
 
-  G4int FindID(const G4VTouchable *);
-
   G4int naming_order_;      ///< Order of the naming scheme
   G4int sensor_depth_;      ///< Depth of the SD in the geometry tree
   G4int mother_depth_;      ///< Depth of the SD's mother in the geometry tree
   G4int grandmother_depth_; ///< Depth of the SD's grandmother in the geometry tree
+  G4int replica_depth_;     ///< Depth of the replica containing the SD's mother
+  G4int mothers_per_replica_; ///< Number of mothers in each replica (0 if none)
 
   G4int box_conf_; ///< Type of configuration of the petit geometry
   G4bool sipm_cells_; ///< True if each individual microcell is simulated in SiPMs
@@ -97,6 +105,9 @@ inline G4int ToFSD::GetDetectorNamingOrder() const { return naming_order_; }
 inline void ToFSD::SetGrandMotherVolumeDepth(G4int d) { grandmother_depth_ = d; }
 inline G4int ToFSD::GetGrandMotherVolumeDepth() const { return grandmother_depth_; }
 
+inline void ToFSD::SetReplicaVolumeDepth(G4int d, G4int n)
+{ replica_depth_ = d; mothers_per_replica_ = n; }
+
 inline void ToFSD::SetBoxConf(petit_conf bc) { box_conf_ = bc; }
 inline void ToFSD::SetSiPMCells(G4bool cells) { sipm_cells_ = cells; }
 
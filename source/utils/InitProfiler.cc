@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------
+// petalosim | InitProfiler.cc
+//
+// This class collects the time spent in each phase of the initialization
+// (construction of the geometry, of the optical properties, of the physics
+// processes and tables...). Phases are timed by creating a Scope at the
+// beginning of the code to be measured; nested phases are also included
+// in the time of the enclosing ones.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "InitProfiler.h"
+#include "PerformanceMonitor.h"
+#include "PetaloPersistencyManager.h"
+
+#include <iomanip>
+#include <sstream>
+
+
+InitProfiler::Scope::Scope(const G4String& phase):
+  phase_(phase), start_(PerformanceMonitor::Now())
+{
+  InitProfiler::Instance().Start(phase_);
+}
+
+
+InitProfiler::Scope::~Scope()
+{
+  InitProfiler::Instance().Add(phase_, PerformanceMonitor::Now() - start_);
+}
+
+
+InitProfiler& InitProfiler::Instance()
+{
+  static InitProfiler instance;
+  return instance;
+}
+
+
+InitProfiler::InitProfiler()
+{
+}
+
+
+InitProfiler::~InitProfiler()
+{
+}
+
+
+InitProfiler::Phase& InitProfiler::Find(const G4String& phase)
+{
+  for (auto& p : phases_)
+    if (p.name == phase) return p;
+  phases_.push_back({phase, 0, 0.});
+  return phases_.back();
+}
+
+
+void InitProfiler::Start(const G4String& phase)
+{
+  Find(phase);
+}
+
+
+void InitProfiler::Add(const G4String& phase, G4double seconds)
+{
+  Phase& p = Find(phase);
+  p.calls++;
+  p.time += seconds;
+}
+
+
+void InitProfiler::Print() const
+{
+  G4cout << "[InitProfiler] Time spent in the initialization:" << G4endl;
+  for (const auto& p : phases_) {
+    G4cout << "   " << std::left << std::setw(45) << p.name << " "
+           << std::right << std::fixed << std::setprecision(3)
+           << std::setw(9) << p.time << " s";
+    if (p.calls > 1) G4cout << " (" << p.calls << " calls)";
+    G4cout << std::defaultfloat << G4endl;
+  }
+}
+
+
+void InitProfiler::SaveRunInfo() const
+{
+  PetaloPersistencyManager* pm = dynamic_cast<PetaloPersistencyManager*>
+    (G4VPersistencyManager::GetPersistencyManager());
+  if (!pm) return;
+
+  for (const auto& p : phases_) {
+    std::ostringstream value;
+    value << p.time << " s";
+    pm->SetRunInfo("init_time_" + p.name, value.str());
+  }
+}
@@ -0,0 +1,60 @@
+// ----------------------------------------------------------------------------
+// petalosim | InitProfiler.h
+//
+// This class collects the time spent in each phase of the initialization
+// (construction of the geometry, of the optical properties, of the physics
+// processes and tables...). Phases are timed by creating a Scope at the
+// beginning of the code to be measured; nested phases are also included
+// in the time of the enclosing ones.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef INIT_PROFILER_H
+#define INIT_PROFILER_H
+
+#include <globals.hh>
+
+#include <vector>
+
+class InitProfiler
+{
+public:
+  /// Adds the time elapsed during its lifetime to a phase
+  class Scope
+  {
+  public:
+    Scope(const G4String& phase);
+    ~Scope();
+  private:
+    G4String phase_;
+    G4double start_;
+  };
+
+  static InitProfiler& Instance();
+
+  /// Register a phase when it starts, so that phases are kept in that order
+  void Start(const G4String& phase);
+  void Add(const G4String& phase, G4double seconds);
+
+  /// Print the time of each phase, in the order they started
+  void Print() const;
+  /// Add the time of each phase to the configuration table
+  void SaveRunInfo() const;
+
+private:
+  InitProfiler();
+  ~InitProfiler();
+
+  struct Phase {
+    G4String name;
+    G4int calls;
+    G4double time; ///< seconds
+  };
+
+  Phase& Find(const G4String& phase);
+
+  std::vector<Phase> phases_;
+};
+
+#endif
@@ -0,0 +1,148 @@
+// ----------------------------------------------------------------------------
+// petalosim | PerformanceMonitor.cc
+//
+// This class measures the throughput of the simulation: events per second,
+// optical photons tracked and photons detected per event, time spent in
+// tracking, in storing the events and in writing them to file, and the
+// peak resident memory. It is enabled with a messenger command and its
+// summary is printed and saved in the configuration table at the end
+// of the run.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PerformanceMonitor.h"
+
+#include <G4GenericMessenger.hh>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <sstream>
+
+
+PerformanceMonitor::StageTimer::StageTimer(Stage stage):
+  stage_(stage), start_(0.), nested_start_(0.)
+{
+  PerformanceMonitor& monitor = PerformanceMonitor::Instance();
+  if (monitor.IsEnabled()) {
+    start_ = Now();
+    nested_start_ = monitor.TotalStageTime();
+  }
+}
+
+
+PerformanceMonitor::StageTimer::~StageTimer()
+{
+  PerformanceMonitor& monitor = PerformanceMonitor::Instance();
+  if (!monitor.IsEnabled()) return;
+
+  // Subtract the time already added by the nested timers
+  G4double nested = monitor.TotalStageTime() - nested_start_;
+  monitor.AddStageTime(stage_, Now() - start_ - nested);
+}
+
+
+PerformanceMonitor& PerformanceMonitor::Instance()
+{
+  static G4ThreadLocal PerformanceMonitor* instance = nullptr;
+  if (!instance) instance = new PerformanceMonitor();
+  return *instance;
+}
+
+
+PerformanceMonitor::PerformanceMonitor(): enabled_(false)
+{
+  msg_ = new G4GenericMessenger(this, "/petalosim/performance/",
+                                "Control commands of the performance monitor.");
+  msg_->DeclareProperty("enable", enabled_,
+                        "Measure the throughput of the simulation.");
+
+  Reset();
+}
+
+
+PerformanceMonitor::~PerformanceMonitor()
+{
+  delete msg_;
+}
+
+
+G4double PerformanceMonitor::Now()
+{
+  return std::chrono::duration<G4double>
+    (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void PerformanceMonitor::Reset()
+{
+  n_events_         = 0;
+  n_saved_          = 0;
+  first_begin_      = 0.;
+  last_end_         = 0.;
+  event_start_      = 0.;
+  tracking_time_    = 0.;
+  stage_time_[kStore] = 0.;
+  stage_time_[kFlush] = 0.;
+  optical_photons_  = 0;
+  detected_photons_ = 0.;
+}
+
+
+void PerformanceMonitor::BeginEvent()
+{
+  if (!enabled_) return;
+
+  event_start_ = Now();
+  if (n_events_ == 0) first_begin_ = event_start_;
+}
+
+
+void PerformanceMonitor::EndEvent()
+{
+  if (!enabled_) return;
+
+  last_end_ = Now();
+  tracking_time_ += last_end_ - event_start_;
+  n_events_++;
+}
+
+
+std::vector<std::pair<G4String, G4String>> PerformanceMonitor::Summary() const
+{
+  // Peak resident memory, in kB on Linux
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  G4double elapsed = last_end_ - first_begin_;
+
+  auto format = [](G4double value) {
+    std::ostringstream os;
+    os << value;
+    return G4String(os.str());
+  };
+
+  std::vector<std::pair<G4String, G4String>> summary;
+  summary.emplace_back("perf_events", std::to_string(n_events_));
+  summary.emplace_back("perf_events_per_second",
+                       format(elapsed > 0. ? n_events_ / elapsed : 0.));
+  summary.emplace_back("perf_optical_photons_per_event",
+                       format(n_events_ > 0 ? G4double(optical_photons_) / n_events_ : 0.));
+  summary.emplace_back("perf_detected_photons_per_saved_event",
+                       format(n_saved_ > 0 ? detected_photons_ / n_saved_ : 0.));
+  summary.emplace_back("perf_tracking_time", format(tracking_time_) + " s");
+  summary.emplace_back("perf_store_time", format(stage_time_[kStore]) + " s");
+  summary.emplace_back("perf_flush_time", format(stage_time_[kFlush]) + " s");
+  summary.emplace_back("perf_max_rss", format(usage.ru_maxrss / 1024.) + " MB");
+
+  return summary;
+}
+
+
+void PerformanceMonitor::Print() const
+{
+  G4cout << "[PerformanceMonitor] Summary of the run:" << G4endl;
+  for (const auto& [key, value] : Summary())
+    G4cout << "   " << key << " = " << value << G4endl;
+}
@@ -0,0 +1,119 @@
+// ----------------------------------------------------------------------------
+// petalosim | PerformanceMonitor.h
+//
+// This class measures the throughput of the simulation: events per second,
+// optical photons tracked and photons detected per event, time spent in
+// tracking, in storing the events and in writing them to file, and the
+// peak resident memory. It is enabled with a messenger command and its
+// summary is printed and saved in the configuration table at the end
+// of the run. It is not saved in the checkpoints, so the summary of a
+// resumed run only measures the events simulated after resuming.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PERFORMANCE_MONITOR_H
+#define PERFORMANCE_MONITOR_H
+
+#include <globals.hh>
+
+#include <utility>
+#include <vector>
+
+class G4GenericMessenger;
+
+class PerformanceMonitor
+{
+public:
+  /// Stages whose time is measured besides tracking
+  enum Stage {kStore, kFlush};
+
+  /// Adds the time elapsed during its lifetime to a stage,
+  /// if the monitor is enabled. The time of the timers nested in it
+  /// is only added to their own stage, so the store time does not
+  /// include the writing of the staged events done while storing.
+  class StageTimer
+  {
+  public:
+    StageTimer(Stage stage);
+    ~StageTimer();
+  private:
+    Stage stage_;
+    G4double start_;
+    G4double nested_start_; ///< time of all the stages at the start
+  };
+
+  /// Return the instance of the current thread
+  static PerformanceMonitor& Instance();
+
+  G4bool IsEnabled() const;
+
+  /// Hooks at the beginning and at the end of the tracking of an event.
+  /// They are only called from the petalosim event actions, so runs
+  /// with other event actions do not measure the tracking time.
+  void BeginEvent();
+  void EndEvent();
+
+  void CountOpticalPhoton();
+  void CountSavedEvent();
+  void AddDetectedPhotons(G4double n);
+  void AddStageTime(Stage stage, G4double seconds);
+  /// Return the time added to all the stages
+  G4double TotalStageTime() const;
+
+  /// Return the measurements of the run as (key, value) pairs
+  std::vector<std::pair<G4String, G4String>> Summary() const;
+  /// Print the summary of the run
+  void Print() const;
+  /// Start the measurements of a new run
+  void Reset();
+
+  /// Wall-clock time in seconds
+  static G4double Now();
+
+private:
+  PerformanceMonitor();
+  ~PerformanceMonitor();
+
+  G4GenericMessenger* msg_;
+  G4bool enabled_;
+
+  G4int n_events_;
+  G4int n_saved_;            ///< events whose detected photons are counted
+  G4double first_begin_;     ///< start of the first event of the run
+  G4double last_end_;        ///< end of the last event of the run
+  G4double event_start_;
+  G4double tracking_time_;
+  G4double stage_time_[2];   ///< indexed by Stage
+  G4long optical_photons_;
+  G4double detected_photons_;
+};
+
+// INLINE DEFINITIONS //////////////////////////////////////////////
+
+inline G4bool PerformanceMonitor::IsEnabled() const
+{
+  return enabled_;
+}
+inline void PerformanceMonitor::CountOpticalPhoton()
+{
+  if (enabled_) optical_photons_++;
+}
+inline void PerformanceMonitor::CountSavedEvent()
+{
+  if (enabled_) n_saved_++;
+}
+inline void PerformanceMonitor::AddDetectedPhotons(G4double n)
+{
+  if (enabled_) detected_photons_ += n;
+}
+inline void PerformanceMonitor::AddStageTime(Stage stage, G4double seconds)
+{
+  stage_time_[stage] += seconds;
+}
+inline G4double PerformanceMonitor::TotalStageTime() const
+{
+  return stage_time_[kStore] + stage_time_[kFlush];
+}
+
+#endif
@@ -10,6 +10,8 @@
 
 #include <Randomize.hh>
 
+#include <cstdint>
+
 #include <CLHEP/Units/PhysicalConstants.h>
 
 using namespace CLHEP;
@@ -39,3 +41,27 @@ std::tuple<G4ThreeVector, G4double, G4double> CalculateNonCollinearKinematicInBo
 
   return std::make_tuple(dir2, e1, e2);
 }
+
+G4long DeriveSeed(G4long seed, G4long index)
+{
+  // splitmix64 finalizer of the combined seed and index
+  uint64_t z = (uint64_t)seed + 0x9e3779b97f4a7c15ULL * ((uint64_t)index + 1);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z = z ^ (z >> 31);
+
+  return (G4long)z;
+}
+
+void SeedEngine(G4long seed, G4long index)
+{
+  uint64_t z = (uint64_t)DeriveSeed(seed, index);
+
+  // CLHEP engines take positive 32-bit seeds in a zero-terminated list,
+  // so a zero half (one case in 2^32) is replaced to keep both seeds
+  long seeds[3] = {(long)(z & 0xffffffff), (long)(z >> 32), 0};
+  for (int i=0; i<2; ++i)
+    if (seeds[i] == 0) seeds[i] = 1;
+
+  HepRandom::setTheSeeds(seeds);
+}
@@ -20,6 +20,15 @@ G4ThreeVector GenerateNonCollinearVector(G4ThreeVector dir, G4double angle);
 // produced in the annihilation of a positron in a body tissue
 std::tuple<G4ThreeVector, G4double, G4double> CalculateNonCollinearKinematicInBodyTissue(G4ThreeVector dir);
 
+// Returns a 64-bit seed derived from a run seed and an index (a process or
+// an event), so that seeds of consecutive indices give uncorrelated random
+// sequences
+G4long DeriveSeed(G4long seed, G4long index);
+
+// Seeds the random engine with the two 32-bit halves of the seed derived
+// from a run seed and an index, keeping all the bits of the derived seed
+void SeedEngine(G4long seed, G4long index);
+
 // 0 is the default configuration, used also for non-petit geometries
 // 1 is the Hamamatsu configuration with IDs 11, 12, ... 88
 // 2 for the moment is like the default, by it could be of use in the future
@@ -0,0 +1,206 @@
+// ----------------------------------------------------------------------------
+// petalosim | VoxelPointSampler.cc
+//
+// This class generates random points following a distribution defined on
+// a grid of voxels, read from a binary file. The file contains a header
+// with the number of voxels (3 ints) and the lengths (3 floats, in mm) of
+// the grid along x, y and z, followed by the cumulative distribution of
+// the voxels (one float per voxel, with z running fastest). The file is
+// memory-mapped and converted into an alias table, so that each voxel is
+// selected in constant time; the point is then drawn uniformly inside it.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#include "VoxelPointSampler.h"
+#include "InitProfiler.h"
+
+#include <G4Exception.hh>
+#include <Randomize.hh>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+
+VoxelPointSampler::VoxelPointSampler(const G4String& file_name,
+                                     G4ThreeVector origin):
+  n_x_(0), n_y_(0), n_z_(0), l_x_(0.), l_y_(0.), l_z_(0.), origin_(origin)
+{
+  InitProfiler::Scope profile("VoxelPointSampler");
+
+  int fd = open(file_name.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) close(fd);
+    G4Exception("[VoxelPointSampler]", "VoxelPointSampler()",
+                FatalErrorInArgument,
+                ("Cannot open the point file " + file_name).c_str());
+    return;
+  }
+
+  const std::size_t header_size = 3 * sizeof(int) + 3 * sizeof(float);
+  std::size_t file_size = st.st_size;
+
+  void* data = MAP_FAILED;
+  if (file_size >= header_size)
+    data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    G4Exception("[VoxelPointSampler]", "VoxelPointSampler()",
+                FatalErrorInArgument,
+                ("Cannot map the point file " + file_name).c_str());
+    return;
+  }
+
+  const char* bytes = static_cast<const char*>(data);
+  int n[3];
+  float l[3];
+  std::memcpy(n, bytes, sizeof(n));
+  std::memcpy(l, bytes + sizeof(n), sizeof(l));
+  n_x_ = n[0]; n_y_ = n[1]; n_z_ = n[2];
+  l_x_ = l[0]; l_y_ = l[1]; l_z_ = l[2];
+
+  std::size_t n_voxels = std::size_t(std::max(n_x_, 0)) *
+    std::size_t(std::max(n_y_, 0)) * std::size_t(std::max(n_z_, 0));
+
+  if (n_voxels == 0 || n_voxels > std::numeric_limits<std::uint32_t>::max() ||
+      file_size < header_size + n_voxels * sizeof(float)) {
+    munmap(data, file_size);
+    G4Exception("[VoxelPointSampler]", "VoxelPointSampler()",
+                FatalErrorInArgument,
+                ("Wrong size of the point file " + file_name).c_str());
+    return;
+  }
+
+  // The file stores the cumulative distribution: voxel i is selected when
+  // cdf[i] <= rnd < cdf[i+1], and the last one when rnd >= cdf[n-1]
+  const float* cdf = reinterpret_cast<const float*>(bytes + header_size);
+  alias_prob_.resize(n_voxels);
+  for (std::size_t i=0; i<n_voxels; ++i) {
+    G4float next = (i + 1 < n_voxels) ? cdf[i+1] : 1.f;
+    alias_prob_[i] = std::max(next - cdf[i], 0.f);
+  }
+
+  munmap(data, file_size);
+
+  BuildAliasTable();
+
+  G4cout << "[VoxelPointSampler] Read distribution of (" << n_x_ << ", "
+         << n_y_ << ", " << n_z_ << ") voxels, with lengths (" << l_x_
+         << ", " << l_y_ << ", " << l_z_ << ") mm from " << file_name
+         << G4endl;
+}
+
+
+VoxelPointSampler::VoxelPointSampler(G4int n_x, G4int n_y, G4int n_z,
+                                     G4ThreeVector lengths,
+                                     std::vector<G4float>&& weights,
+                                     G4ThreeVector origin):
+  n_x_(n_x), n_y_(n_y), n_z_(n_z),
+  l_x_(lengths.x()), l_y_(lengths.y()), l_z_(lengths.z()), origin_(origin),
+  alias_prob_(std::move(weights))
+{
+  if (n_x_ <= 0 || n_y_ <= 0 || n_z_ <= 0 ||
+      alias_prob_.size() != std::size_t(n_x_) * n_y_ * n_z_) {
+    G4Exception("[VoxelPointSampler]", "VoxelPointSampler()",
+                FatalErrorInArgument,
+                "The number of weights does not match the voxels.");
+    return;
+  }
+
+  BuildAliasTable();
+}
+
+
+VoxelPointSampler::~VoxelPointSampler()
+{
+}
+
+
+void VoxelPointSampler::BuildAliasTable()
+{
+  // Vose's method, done in place so that no other array of the size of
+  // the grid is needed. The weights are scaled so that their mean is 1;
+  // the voxels below 1 ("small") and above ("large") are found by two
+  // indices that only move forward, and each small voxel takes the rest
+  // of its probability from the current large one.
+  std::vector<G4float>& p = alias_prob_;
+  std::size_t n = p.size();
+  G4double sum = 0.;
+  for (auto w : p) sum += w;
+
+  if (!(sum > 0.)) {
+    G4Exception("[VoxelPointSampler]", "BuildAliasTable()",
+                FatalErrorInArgument, "The point distribution is empty.");
+    return;
+  }
+
+  G4float scale = n / sum;
+  for (auto& w : p) w *= scale;
+
+  // A voxel whose alias is itself has not been paired yet
+  alias_.resize(n);
+  for (std::size_t i=0; i<n; ++i) alias_[i] = i;
+
+  auto next_small = [&](std::size_t i) {
+    while (i < n && p[i] >= 1.f) ++i;
+    return i;
+  };
+  auto next_large = [&](std::size_t i) {
+    while (i < n && p[i] < 1.f) ++i;
+    return i;
+  };
+
+  std::size_t scan = next_small(0);
+  std::size_t small = scan;
+  std::size_t large = next_large(0);
+
+  while (small < n && large < n) {
+    alias_[small] = large;
+    p[large] -= 1.f - p[small];
+    if (small == scan) scan = next_small(scan + 1);
+
+    if (p[large] < 1.f) {
+      // The large voxel becomes small. If the scan has already passed
+      // it, it is paired now; otherwise the scan will find it later
+      std::size_t demoted = large;
+      large = next_large(large + 1);
+      if (demoted < scan) {
+        small = demoted;
+        continue;
+      }
+    }
+    small = scan;
+  }
+
+  // The voxels left unpaired have probability 1 up to rounding errors
+  for (std::size_t i=0; i<n; ++i)
+    if (alias_[i] == i) p[i] = 1.f;
+}
+
+
+G4ThreeVector VoxelPointSampler::GenerateVertex() const
+{
+  std::size_t n = alias_.size();
+  std::size_t voxel = std::min<std::size_t>(G4UniformRand() * n, n - 1);
+  if (G4UniformRand() >= alias_prob_[voxel]) voxel = alias_[voxel];
+
+  G4int nx = voxel / (n_y_ * n_z_);
+  G4int ny = (voxel / n_z_) % n_y_;
+  G4int nz = voxel % n_z_;
+
+  // Uniform point inside the voxel
+  G4double x = l_x_ * ((nx + G4UniformRand()) / n_x_ - 0.5);
+  G4double y = l_y_ * ((ny + G4UniformRand()) / n_y_ - 0.5);
+  G4double z = l_z_ * ((nz + G4UniformRand()) / n_z_ - 0.5);
+
+  return origin_ + G4ThreeVector(x, y, z);
+}
@@ -0,0 +1,59 @@
+// ----------------------------------------------------------------------------
+// petalosim | VoxelPointSampler.h
+//
+// This class generates random points following a distribution defined on
+// a grid of voxels, read from a binary file. The file contains a header
+// with the number of voxels (3 ints) and the lengths (3 floats, in mm) of
+// the grid along x, y and z, followed by the cumulative distribution of
+// the voxels (one float per voxel, with z running fastest). The file is
+// memory-mapped and converted into an alias table, so that each voxel is
+// selected in constant time; the point is then drawn uniformly inside it.
+//
+// The PETALO Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef VOXEL_POINT_SAMPLER_H
+#define VOXEL_POINT_SAMPLER_H
+
+#include <globals.hh>
+#include <G4ThreeVector.hh>
+
+#include <cstdint>
+#include <vector>
+
+class VoxelPointSampler
+{
+public:
+  /// Read the distribution from a file; the grid is centred at origin
+  VoxelPointSampler(const G4String& file_name,
+                    G4ThreeVector origin = G4ThreeVector(0., 0., 0.));
+  /// Use the given weights of the voxels, with z running fastest
+  /// (the vector is moved into the table)
+  VoxelPointSampler(G4int n_x, G4int n_y, G4int n_z, G4ThreeVector lengths,
+                    std::vector<G4float>&& weights,
+                    G4ThreeVector origin = G4ThreeVector(0., 0., 0.));
+  ~VoxelPointSampler();
+
+  G4ThreeVector GenerateVertex() const;
+
+  G4int NVoxels() const;
+
+private:
+  /// Build the alias table in place from the weights of the
+  /// voxels, stored in alias_prob_
+  void BuildAliasTable();
+
+  G4int n_x_, n_y_, n_z_;
+  G4double l_x_, l_y_, l_z_;
+  G4ThreeVector origin_;
+
+  std::vector<G4float> alias_prob_;  ///< Probability of keeping each voxel
+  std::vector<std::uint32_t> alias_; ///< Voxel chosen otherwise
+};
+
+inline G4int VoxelPointSampler::NVoxels() const
+{
+  return n_x_ * n_y_ * n_z_;
+}
+
+#endif
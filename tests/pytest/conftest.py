@@ -1,5 +1,6 @@
 import pytest
 import os
+import glob
 
 
 @pytest.fixture(scope = 'session')
@@ -69,6 +70,170 @@ def file_name_phantom(output_tmpdir, base_name_phantom):
     return os.path.join(output_tmpdir, base_name_phantom+'.h5')
 
 
+@pytest.fixture(scope = 'session')
+def base_name_roulette_off():
+    return 'PET_roulette_off_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_roulette_on():
+    return 'PET_roulette_on_test'
+
+@pytest.fixture(scope = 'session')
+def file_names_roulette(output_tmpdir, base_name_roulette_off, base_name_roulette_on):
+    return (os.path.join(output_tmpdir, base_name_roulette_off+'.h5'),
+            os.path.join(output_tmpdir, base_name_roulette_on +'.h5'))
+
+
+@pytest.fixture(scope = 'session')
+def base_name_seeding_serial():
+    return 'PET_seeding_serial_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_seeding_jobs():
+    return 'PET_seeding_jobs_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_seeding_jobs_run_seed():
+    return 'PET_seeding_jobs_run_seed_test'
+
+@pytest.fixture(scope = 'session')
+def file_names_seeding(output_tmpdir, base_name_seeding_serial,
+                       base_name_seeding_jobs, base_name_seeding_jobs_run_seed):
+    return (os.path.join(output_tmpdir, base_name_seeding_serial       +'.h5'),
+            os.path.join(output_tmpdir, base_name_seeding_jobs         +'.h5'),
+            os.path.join(output_tmpdir, base_name_seeding_jobs_run_seed+'.h5'))
+
+
+@pytest.fixture(scope = 'session')
+def base_name_resume_reference():
+    return 'PET_resume_reference_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_resume():
+    return 'PET_resume_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_resume_reference_run_seed():
+    return 'PET_resume_reference_run_seed_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_resume_run_seed():
+    return 'PET_resume_run_seed_test'
+
+@pytest.fixture(scope = 'module')
+def file_names_resume(output_tmpdir, resume_params):
+    base_name_reference, base_name_resume, _ = resume_params
+    return (os.path.join(output_tmpdir, base_name_reference+'.h5'),
+            os.path.join(output_tmpdir, base_name_resume   +'.h5'))
+
+
+@pytest.fixture(scope = 'session')
+def base_name_rollover_reference():
+    return 'PET_rollover_reference_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_rollover():
+    return 'PET_rollover_test'
+
+@pytest.fixture(scope = 'session')
+def file_names_rollover(output_tmpdir, base_name_rollover_reference, base_name_rollover):
+    parts = sorted(glob.glob(os.path.join(output_tmpdir, base_name_rollover+'.[0-9][0-9][0-9].h5')))
+    return os.path.join(output_tmpdir, base_name_rollover_reference+'.h5'), parts
+
+
+@pytest.fixture(scope = 'session')
+def base_name_geometry_built():
+    return 'PET_geometry_built_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_geometry_cached():
+    return 'PET_geometry_cached_test'
+
+@pytest.fixture(scope = 'session')
+def geometry_cache_dir(output_tmpdir):
+    return os.path.join(output_tmpdir, 'geometry_cache')
+
+@pytest.fixture(scope = 'session')
+def file_names_geometry_cache(output_tmpdir, base_name_geometry_built, base_name_geometry_cached):
+    return (os.path.join(output_tmpdir, base_name_geometry_built +'.h5'),
+            os.path.join(output_tmpdir, base_name_geometry_cached+'.h5'))
+
+
+@pytest.fixture(scope = 'session')
+def base_name_positron_range():
+    return 'PET_positron_range_test'
+
+@pytest.fixture(scope = 'session')
+def file_name_positron_range(output_tmpdir, base_name_positron_range):
+    return os.path.join(output_tmpdir, base_name_positron_range+'.h5')
+
+
+@pytest.fixture(scope = 'session')
+def base_name_parametric_drift():
+    return 'PET_parametric_drift_test'
+
+@pytest.fixture(scope = 'session')
+def file_name_parametric_drift(output_tmpdir, base_name_parametric_drift):
+    return os.path.join(output_tmpdir, base_name_parametric_drift+'.h5')
+
+
+@pytest.fixture(scope = 'session')
+def base_name_nest_table():
+    return 'PET_nest_table_test'
+
+@pytest.fixture(scope = 'session')
+def file_name_nest_table(output_tmpdir, base_name_nest_table):
+    return os.path.join(output_tmpdir, base_name_nest_table+'.h5')
+
+
+@pytest.fixture(scope = 'session')
+def base_name_voxel_phantom():
+    return 'PET_voxel_phantom_test'
+
+@pytest.fixture(scope = 'session')
+def file_name_voxel_phantom(output_tmpdir, base_name_voxel_phantom):
+    return os.path.join(output_tmpdir, base_name_voxel_phantom+'.h5')
+
+
+@pytest.fixture(scope = 'session')
+def base_name_region_cuts():
+    return 'PET_region_cuts_test'
+
+@pytest.fixture(scope = 'session')
+def file_name_region_cuts_log(output_tmpdir, base_name_region_cuts):
+    return os.path.join(output_tmpdir, base_name_region_cuts+'.log')
+
+
+@pytest.fixture(scope = 'session')
+def base_name_replica_sensors_off():
+    return 'PET_replica_sensors_off_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_replica_sensors_on():
+    return 'PET_replica_sensors_on_test'
+
+@pytest.fixture(scope = 'session')
+def file_names_replica_sensors(output_tmpdir, base_name_replica_sensors_off,
+                               base_name_replica_sensors_on):
+    return (os.path.join(output_tmpdir, base_name_replica_sensors_off+'.h5'),
+            os.path.join(output_tmpdir, base_name_replica_sensors_on +'.h5'))
+
+
+@pytest.fixture(scope = 'session')
+def base_name_replica_blocks_off():
+    return 'PET_replica_blocks_off_test'
+
+@pytest.fixture(scope = 'session')
+def base_name_replica_blocks_on():
+    return 'PET_replica_blocks_on_test'
+
+@pytest.fixture(scope = 'session')
+def file_names_replica_blocks(output_tmpdir, base_name_replica_blocks_off,
+                              base_name_replica_blocks_on):
+    return (os.path.join(output_tmpdir, base_name_replica_blocks_off+'.h5'),
+            os.path.join(output_tmpdir, base_name_replica_blocks_on +'.h5'))
+
+
 @pytest.fixture(scope = 'session')
 def base_name_pyrex():
     return 'PETit_pyrex_test'
@@ -181,6 +346,43 @@ def petalosim_files(request, output_tmpdir):
     return os.path.join(output_tmpdir, request.getfixturevalue(request.param)+'.h5')
 
 
+@pytest.fixture(scope="module",
+                params=[("base_name_roulette_off", False),
+                        ("base_name_roulette_on",  True)],
+                ids=["roulette_off", "roulette_on"])
+def roulette_params(request):
+    base_name, roulette = request.param
+    return request.getfixturevalue(base_name), roulette
+
+
+@pytest.fixture(scope="module",
+                params=[("base_name_seeding_serial",        1, True),
+                        ("base_name_seeding_jobs",          2, True),
+                        ("base_name_seeding_jobs_run_seed", 2, False)],
+                ids=["serial", "jobs", "jobs_run_seed"])
+def seeding_params(request):
+    base_name, njobs, event_seeding = request.param
+    return request.getfixturevalue(base_name), njobs, event_seeding
+
+
+@pytest.fixture(scope="module",
+                params=[("base_name_resume_reference",          "base_name_resume",          True),
+                        ("base_name_resume_reference_run_seed", "base_name_resume_run_seed", False)],
+                ids=["event_seeding", "run_seed"])
+def resume_params(request):
+    base_name_reference, base_name_resume, event_seeding = request.param
+    return (request.getfixturevalue(base_name_reference),
+            request.getfixturevalue(base_name_resume), event_seeding)
+
+
+@pytest.fixture(scope="module",
+                params=["file_names_replica_sensors",
+                        "file_names_replica_blocks"],
+                ids=["replica_sensors", "replica_blocks"])
+def replica_file_names(request):
+    return request.getfixturevalue(request.param)
+
+
 @pytest.fixture(scope="module",
                 params=["params_full_body", "params_nest",
                         "params_ring_tiles"],
@@ -117,3 +117,123 @@ def test_primary_always_exists(petalosim_files):
      primary   = particles.primary.unique()
 
      assert 1 in primary
+
+
+def test_event_tables_in_event_order(petalosim_files):
+     """
+     Check that the rows staged by the writer are written in event order
+     and that the rows of every saved event reach the file.
+     """
+     filename = petalosim_files
+
+     with tb.open_file(filename) as h5out:
+          for table in ['particles', 'hits', 'sns_response',
+                        'tof_sns_response', 'charge_response']:
+               event_ids = h5out.root.MC[table].col('event_id')
+               assert np.all(np.diff(event_ids) >= 0)
+
+     conf         = pd.read_hdf(filename, 'MC/configuration')
+     saved_events = conf[conf.param_key == 'saved_events'].param_value.values
+     particles    = pd.read_hdf(filename, 'MC/particles')
+
+     assert len(saved_events) == 1
+     assert particles.event_id.nunique() == int(saved_events[0])
+
+
+def test_event_seeding_does_not_depend_on_jobs(file_names_seeding):
+     """
+     Check that, with event seeding, splitting the run in processes
+     gives the same events, since each event is seeded from the run
+     seed and its event ID only.
+     """
+     file_serial, file_jobs, _ = file_names_seeding
+
+     particles_serial = pd.read_hdf(file_serial, 'MC/particles')
+     particles_jobs   = pd.read_hdf(file_jobs,   'MC/particles')
+
+     assert len(particles_serial) > 0
+     pd.testing.assert_frame_equal(particles_serial, particles_jobs)
+
+
+def test_processes_do_not_repeat_events(file_names_seeding):
+     """
+     Check that, without event seeding, the processes of a split run
+     are seeded differently and do not simulate the same events.
+     """
+     _, _, file_run_seed = file_names_seeding
+
+     particles = pd.read_hdf(file_run_seed, 'MC/particles')
+     primaries = particles[particles.primary == 1]
+     momenta   = primaries[['initial_momentum_x', 'initial_momentum_y',
+                            'initial_momentum_z']]
+
+     assert np.all(np.unique(primaries.event_id) == np.arange(20))
+     assert not momenta.duplicated().any()
+
+
+def test_resumed_run_equals_uninterrupted_run(file_names_resume):
+     """
+     Check that a run resumed from a checkpoint produces the same
+     events and counters as the same run without interruption.
+     """
+     file_reference, file_resume = file_names_resume
+
+     for table in ['MC/particles', 'MC/hits', 'MC/sns_response']:
+          reference = pd.read_hdf(file_reference, table)
+          resumed   = pd.read_hdf(file_resume,    table)
+          assert len(reference) > 0
+          pd.testing.assert_frame_equal(reference, resumed)
+
+     conf_reference = pd.read_hdf(file_reference, 'MC/configuration')
+     conf_resumed   = pd.read_hdf(file_resume,    'MC/configuration')
+     counters = ['num_events', 'saved_events', 'photon_sink_KAPTON']
+     for key in counters:
+          value_reference = conf_reference[conf_reference.param_key == key].param_value.values
+          value_resumed   = conf_resumed  [conf_resumed  .param_key == key].param_value.values
+          assert len(value_reference) == 1
+          assert value_reference == value_resumed
+
+
+def test_output_rollover(file_names_rollover):
+     """
+     Check that a run split in files of a maximum number of saved events
+     writes the same events and counters as the run in a single file,
+     and that no file is left empty.
+     """
+     file_reference, parts = file_names_rollover
+     max_events = 4
+
+     conf_reference = pd.read_hdf(file_reference, 'MC/configuration')
+     saved_reference = int(conf_reference[conf_reference.param_key == 'saved_events'].param_value.values[0])
+     assert saved_reference > max_events
+     assert len(parts) == (saved_reference + max_events - 1) // max_events
+
+     particles = []
+     totals    = {'num_events': 0, 'saved_events': 0, 'photon_sink_KAPTON': 0}
+     for i, part in enumerate(parts):
+          conf  = pd.read_hdf(part, 'MC/configuration')
+          saved = int(conf[conf.param_key == 'saved_events'].param_value.values[0])
+          if i < len(parts) - 1:
+               assert saved == max_events
+          else:
+               assert 0 < saved <= max_events
+
+          for key in totals:
+               values = conf[conf.param_key == key].param_value.values
+               assert len(values) == 1
+               totals[key] += int(values[0])
+
+          part_particles = pd.read_hdf(part, 'MC/particles')
+          assert part_particles.event_id.nunique() == saved
+          particles.append(part_particles)
+
+     # The files follow each other in event order
+     particles = pd.concat(particles, ignore_index=True)
+     assert np.all(np.diff(particles.event_id.values) >= 0)
+
+     particles_reference = pd.read_hdf(file_reference, 'MC/particles')
+     pd.testing.assert_frame_equal(particles_reference, particles)
+
+     for key, total in totals.items():
+          value = conf_reference[conf_reference.param_key == key].param_value.values
+          assert int(value[0]) == total
@@ -1,6 +1,8 @@
 import pytest
 import os
+import re
 
+import numpy  as np
 import pandas as pd
 
 def test_opt_photons_and_ioni_elec_are_produced_by_nest(file_name_nest):
@@ -13,4 +15,99 @@ def test_opt_photons_and_ioni_elec_are_produced_by_nest(file_name_nest):
     creator_processes = opt_photons_and_elec.creator_proc.unique()
     
     assert creator_processes == ['S1']
-    
+
+
+def test_optical_roulette_preserves_detected_charge(file_names_roulette):
+    """Check that the Russian roulette of optical photons does not change
+    the mean detected charge, since the survivors carry the weight of the
+    killed photons. The survival probability is 0.5, so that the weights
+    are integer and the charge of each sensor is not rounded."""
+
+    file_off, file_on = file_names_roulette
+
+    charge_off = pd.read_hdf(file_off, 'MC/sns_response').charge.sum()
+    charge_on  = pd.read_hdf(file_on,  'MC/sns_response').charge.sum()
+
+    assert charge_off > 0
+    assert charge_on == pytest.approx(charge_off, rel=0.05)
+
+
+def test_parametric_drift_adds_charge_to_the_wires(file_name_parametric_drift):
+    """Check that with the parametric drift the thermal electrons are not
+    tracked, and that their charge reaches the ring of wires within the
+    time needed to drift across the LXe"""
+
+    particles = pd.read_hdf(file_name_parametric_drift, 'MC/particles')
+    assert not (particles.particle_name == 'thermalelectron').any()
+
+    charge = pd.read_hdf(file_name_parametric_drift, 'MC/charge_response')
+    assert charge.charge.sum() > 0
+
+    # Wires with a pitch of 4 mm at the outer radius of the LXe, 410 mm
+    wire_radius = 410. - 0.0005 - 0.005
+    n_wires     = int(2 * np.pi * wire_radius / 4.)
+    assert charge.sensor_id.max() < n_wires
+
+    # At most 3 cm at 2 mm/us, in bins of 1 us
+    assert charge.time_bin.max() <= 16
+
+
+def test_nest_yield_table_preserves_quanta_per_energy(file_name_nest, file_name_nest_table):
+    """Check that the NEST yields interpolated from tables give the same
+    number of quanta (optical photons and thermal electrons) per unit of
+    deposited energy as the direct calculation. The sum of both quanta
+    barely fluctuates, so a tolerance of a few percent is enough."""
+
+    quanta_per_energy = []
+    for file_name in [file_name_nest, file_name_nest_table]:
+        particles = pd.read_hdf(file_name, 'MC/particles')
+        hits      = pd.read_hdf(file_name, 'MC/hits')
+        selection = (particles.particle_name == 'opticalphoton') | (particles.particle_name == 'thermalelectron')
+
+        energy = hits.energy.sum()
+        assert energy > 0
+        assert (particles[selection].creator_proc == 'S1').all()
+        quanta_per_energy.append(selection.sum() / energy)
+
+    direct, tabulated = quanta_per_energy
+    assert tabulated == pytest.approx(direct, rel=0.05)
+
+
+def test_voxel_phantom_uses_regular_navigation(file_name_voxel_phantom):
+    """Check that the gammas cross the voxels of a uniform phantom without
+    stopping at their boundaries, which only the regular navigation does:
+    no transportation step ends in another voxel, and the steps are
+    longer than a voxel"""
+
+    steps = pd.read_hdf(file_name_voxel_phantom, 'DEBUG/steps')
+    steps = steps[(steps.particle_name == 'gamma') & (steps.initial_volume == 'VOXEL')]
+    assert len(steps) > 0
+
+    transport = steps[steps.proc_name == 'Transportation']
+    assert len(transport) > 0
+    assert (transport.final_volume != 'VOXEL').all()
+
+    length = np.sqrt((steps.final_x - steps.initial_x)**2 +
+                     (steps.final_y - steps.initial_y)**2 +
+                     (steps.final_z - steps.initial_z)**2)
+    assert length.max() > 2.5
+
+
+def test_regions_without_cut_use_default_cuts(file_name_region_cuts_log):
+    """Check, in the dump of the regions, that the region with a
+    configured production cut uses it, and that the other regions use
+    the default cut set with /run/setCut instead of having none"""
+
+    log = open(file_name_region_cuts_log).read()
+    assert 'does not have specific production cuts' not in log
+
+    to_mm = {'nm': 1e-6, 'um': 1e-3, 'mm': 1., 'cm': 10., 'm': 1e3, 'km': 1e6}
+    gamma_cuts = {}
+    for region, cut, unit in re.findall(r'Region <(\w+)>.*?Production cuts :\s+gamma\s+([0-9.e+-]+)\s*(\w+)',
+                                        log, re.DOTALL):
+        gamma_cuts[region] = float(cut) * to_mm[unit]
+
+    assert gamma_cuts['ACTIVE'] == pytest.approx(0.5)
+    for region in ['PASSIVE', 'SENSORS']:
+        assert gamma_cuts[region] == pytest.approx(2.)
+
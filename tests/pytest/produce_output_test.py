@@ -3,6 +3,8 @@ import pytest
 import os
 import subprocess
 
+import numpy as np
+
 
 @pytest.mark.order(1)
 def test_create_petalo_output_file_full_body(config_tmpdir, output_tmpdir, PETALODIR, base_name_full_body):
@@ -467,3 +469,920 @@ def test_create_petalo_output_file_phantom(config_tmpdir, output_tmpdir, PETALOD
      petalo_exe = PETALODIR + '/bin/petalo'
      command   = [petalo_exe, '-b', '-n', '10000', init_path]
      p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(7)
+def test_create_petalo_output_file_roulette(config_tmpdir, output_tmpdir, PETALODIR, roulette_params):
+
+     base_name, roulette = roulette_params
+
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingInfinity
+
+### GENERATOR
+/nexus/RegisterGenerator LXeScintillationGenerator
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetSensorsEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingInfinity/depth 3. cm
+/Geometry/FullRingInfinity/sipm_pitch 7. mm
+/Geometry/FullRingInfinity/inner_radius 380. mm
+/Geometry/FullRingInfinity/sipm_rows 278
+/Geometry/FullRingInfinity/instrumented_faces 1
+/Geometry/FullRingInfinity/specific_vertex 0. 395. 0. mm
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 6. mm
+
+/Generator/LXeScintGenerator/region AD_HOC
+/Generator/LXeScintGenerator/nphotons 10000
+
+/PhysicsList/Petalo/optical_roulette {str(roulette).lower()}
+/PhysicsList/Petalo/roulette_boundaries 1
+/PhysicsList/Petalo/roulette_survival 0.5
+
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '10', init_path]
+     p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(8)
+def test_create_petalo_output_file_seeding(config_tmpdir, output_tmpdir, PETALODIR, seeding_params):
+
+     base_name, njobs, event_seeding = seeding_params
+
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region CENTER
+
+/petalosim/persistency/event_seeding {str(event_seeding).lower()}
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '20', '-j', str(njobs), init_path]
+     p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(9)
+def test_create_petalo_output_file_resume(config_tmpdir, output_tmpdir, PETALODIR, resume_params):
+     """
+     The reference job runs 20 events at once. The other job stops
+     after 10 events, at a checkpoint, and is then resumed up to 20.
+     Without event seeding, the state of the random engine is
+     restored from the checkpoint.
+     """
+     base_name_resume_reference, base_name_resume, event_seeding = resume_params
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+
+     for base_name in [base_name_resume_reference, base_name_resume]:
+
+          init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+          init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+          init_file = open(init_path,'w')
+          init_file.write(init_text)
+          init_file.close()
+
+          config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+/Geometry/FullRingTiles/photon_sink KAPTON
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region CENTER
+
+/petalosim/persistency/event_seeding {str(event_seeding).lower()}
+/petalosim/persistency/checkpoint_interval 5
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+          config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+          config_file = open(config_path,'w')
+          config_file.write(config_text)
+          config_file.close()
+
+     init_reference = os.path.join(config_tmpdir, base_name_resume_reference+'.init.mac')
+     init_resume    = os.path.join(config_tmpdir, base_name_resume          +'.init.mac')
+
+     commands = [[petalo_exe, '-b', '-n', '20',       init_reference],
+                 [petalo_exe, '-b', '-n', '10',       init_resume],
+                 [petalo_exe, '-b', '-n', '20', '-r', init_resume]]
+     for command in commands:
+          p = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(10)
+def test_create_petalo_output_file_replica_sensors(config_tmpdir, output_tmpdir, PETALODIR, base_name_replica_sensors_off, base_name_replica_sensors_on):
+     """
+     The same job with the SiPMs placed one by one and as replicas,
+     saving the positions of all the sensors.
+     """
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+
+     for base_name, replica in [(base_name_replica_sensors_off, False),
+                                (base_name_replica_sensors_on,  True)]:
+
+          init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingInfinity
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+          init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+          init_file = open(init_path,'w')
+          init_file.write(init_text)
+          init_file.close()
+
+          config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingInfinity/depth 3. cm
+/Geometry/FullRingInfinity/sipm_pitch 7. mm
+/Geometry/FullRingInfinity/inner_radius 380. mm
+/Geometry/FullRingInfinity/sipm_rows 278
+/Geometry/FullRingInfinity/instrumented_faces 2
+/Geometry/FullRingInfinity/specific_vertex 0. 0. 0. cm
+/Geometry/FullRingInfinity/replica_sensors {str(replica).lower()}
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 6. mm
+
+/Generator/Back2back/region AD_HOC
+
+/process/optical/processActivation Cerenkov false
+
+/petalosim/persistency/all_sensor_positions true
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+          config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+          config_file = open(config_path,'w')
+          config_file.write(config_text)
+          config_file.close()
+
+          command = [petalo_exe, '-b', '-n', '1', init_path]
+          p       = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(10)
+def test_create_petalo_output_file_replica_blocks(config_tmpdir, output_tmpdir, PETALODIR, base_name_replica_blocks_off, base_name_replica_blocks_on):
+     """
+     The same job with the tiles placed one by one and as replicas,
+     saving the positions of all the sensors.
+     """
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+
+     for base_name, replica in [(base_name_replica_blocks_off, False),
+                                (base_name_replica_blocks_on,  True)]:
+
+          init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+          init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+          init_file = open(init_path,'w')
+          init_file.write(init_text)
+          init_file.close()
+
+          config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+/Geometry/FullRingTiles/replica_blocks {str(replica).lower()}
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region CENTER
+
+/petalosim/persistency/all_sensor_positions true
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+          config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+          config_file = open(config_path,'w')
+          config_file.write(config_text)
+          config_file.close()
+
+          command = [petalo_exe, '-b', '-n', '1', init_path]
+          p       = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(11)
+def test_create_petalo_output_file_rollover(config_tmpdir, output_tmpdir, PETALODIR, base_name_rollover_reference, base_name_rollover):
+     """
+     The same job written to a single file and split in files
+     of at most 4 saved events.
+     """
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+
+     for base_name, max_events in [(base_name_rollover_reference, 0),
+                                   (base_name_rollover,           4)]:
+
+          init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+          init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+          init_file = open(init_path,'w')
+          init_file.write(init_text)
+          init_file.close()
+
+          config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+/Geometry/FullRingTiles/photon_sink KAPTON
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region CENTER
+
+/petalosim/persistency/max_events_per_file {max_events}
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+          config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+          config_file = open(config_path,'w')
+          config_file.write(config_text)
+          config_file.close()
+
+          command = [petalo_exe, '-b', '-n', '20', init_path]
+          p       = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(12)
+def test_create_petalo_output_file_geometry_cache(config_tmpdir, output_tmpdir, PETALODIR, base_name_geometry_built, base_name_geometry_cached, geometry_cache_dir):
+     """
+     The same job with the geometry built and read from the cache.
+     The cached job runs twice: the first run writes the cache
+     and the second one, which is kept, reads it.
+     """
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+
+     for base_name, cache_dir in [(base_name_geometry_built,  ''),
+                                  (base_name_geometry_cached, geometry_cache_dir)]:
+
+          init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction PetaloTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name}.config.mac
+"""
+          init_path = os.path.join(config_tmpdir, base_name+'.init.mac')
+          init_file = open(init_path,'w')
+          init_file.write(init_text)
+          init_file.close()
+
+          cache_command = f"/petalosim/geometry/cache/directory {cache_dir}" if cache_dir else ""
+
+          config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region CENTER
+
+{cache_command}
+
+/petalosim/persistency/all_sensor_positions true
+/petalosim/persistency/output_file {output_tmpdir}/{base_name}
+/nexus/random_seed 16062020
+
+"""
+          config_path = os.path.join(config_tmpdir, base_name+'.config.mac')
+          config_file = open(config_path,'w')
+          config_file.write(config_text)
+          config_file.close()
+
+          command = [petalo_exe, '-b', '-n', '5', init_path]
+          runs    = 2 if cache_dir else 1
+          for _ in range(runs):
+               p = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(12)
+def test_create_petalo_output_file_positron_range(config_tmpdir, output_tmpdir, PETALODIR, base_name_positron_range):
+     """
+     Back-to-back gammas emitted from a point source with a positron
+     range table whose distances are all in the bin from 1 to 1.01 mm,
+     and a prompt gamma emitted from the decay point.
+     """
+     range_path = os.path.join(config_tmpdir, base_name_positron_range+'.range.txt')
+     counts     = ['0'] * 3000
+     counts[100] = '1'
+     range_file = open(range_path,'w')
+     range_file.write('# material bin_width(mm) n_bins counts\n')
+     range_file.write('G4_WATER 0.01 3000 ' + ' '.join(counts) + '\n')
+     range_file.close()
+
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingInfinity
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction DefaultTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name_positron_range}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name_positron_range+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingInfinity/depth 3. cm
+/Geometry/FullRingInfinity/sipm_pitch 7. mm
+/Geometry/FullRingInfinity/inner_radius 380. mm
+/Geometry/FullRingInfinity/sipm_rows 278
+/Geometry/FullRingInfinity/instrumented_faces 1
+/Geometry/FullRingInfinity/specific_vertex 0. 0. 0. cm
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 6. mm
+
+/Generator/Back2back/region AD_HOC
+/Generator/Back2back/positron_range_material G4_WATER
+/Generator/Back2back/positron_range_file {range_path}
+/Generator/Back2back/prompt_gamma_energy 1274.5 keV
+
+/petalosim/persistency/output_file {output_tmpdir}/{base_name_positron_range}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name_positron_range+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '20', init_path]
+     p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(12)
+def test_create_petalo_output_file_parametric_drift(config_tmpdir, output_tmpdir, PETALODIR, base_name_parametric_drift):
+     """
+     NEST job with a ring of wires, where the thermal electrons
+     are drifted to the wires with the parametric model.
+     """
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingInfinity
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction OpticalTrackingAction
+/nexus/RegisterStackingAction PetNESTStackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name_parametric_drift}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name_parametric_drift+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingInfinity/depth 3. cm
+/Geometry/FullRingInfinity/sipm_pitch 7. mm
+/Geometry/FullRingInfinity/inner_radius 380. mm
+/Geometry/FullRingInfinity/sipm_rows 278
+/Geometry/FullRingInfinity/instrumented_faces 1
+/Geometry/FullRingInfinity/specific_vertex 0. 0. 0. cm
+/Geometry/FullRingInfinity/charge_detector true
+/Geometry/FullRingInfinity/wire_pitch 4. mm
+/Geometry/FullRingInfinity/wire_time_bin 1. microsecond
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 6. mm
+
+/Generator/Back2back/region AD_HOC
+
+/process/optical/processActivation Scintillation false
+/process/optical/processActivation Cerenkov false
+
+/PhysicsList/Petalo/nest true
+
+/Actions/PetNESTStackingAction/parametric_drift true
+/Actions/PetNESTStackingAction/drift_velocity 2.
+/Actions/PetNESTStackingAction/lifetime 0. microsecond
+
+/petalosim/persistency/output_file {output_tmpdir}/{base_name_parametric_drift}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name_parametric_drift+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '5', init_path]
+     p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(12)
+def test_create_petalo_output_file_nest_table(config_tmpdir, output_tmpdir, PETALODIR, base_name_nest_table):
+     """
+     The same job as the NEST one, with the yields interpolated
+     from tables.
+     """
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics G4OpticalPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingInfinity
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction OpticalTrackingAction
+/nexus/RegisterStackingAction PetNESTStackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name_nest_table}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name_nest_table+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingInfinity/depth 3. cm
+/Geometry/FullRingInfinity/sipm_pitch 7. mm
+/Geometry/FullRingInfinity/inner_radius 380. mm
+/Geometry/FullRingInfinity/sipm_rows 278
+/Geometry/FullRingInfinity/instrumented_faces 1
+/Geometry/FullRingInfinity/specific_vertex 0. 0. 0. cm
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/visibility true
+/Geometry/SiPMpet/size 6. mm
+
+/Generator/Back2back/region AD_HOC
+
+/process/optical/processActivation Scintillation false
+/process/optical/processActivation Cerenkov false
+
+/PhysicsList/Petalo/nest true
+/PhysicsList/Petalo/nest_yield_table true
+
+/petalosim/persistency/output_file {output_tmpdir}/{base_name_nest_table}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name_nest_table+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '1', init_path]
+     p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(12)
+def test_create_petalo_output_file_voxel_phantom(config_tmpdir, output_tmpdir, PETALODIR, base_name_voxel_phantom):
+     """
+     Back-to-back gammas from a uniform water phantom of 40x40x40
+     voxels of 2.5 mm, saving the steps of the gammas.
+     """
+     n_voxels      = 40
+     material_path = os.path.join(config_tmpdir, base_name_voxel_phantom+'.materials.raw')
+     activity_path = os.path.join(config_tmpdir, base_name_voxel_phantom+'.activity.raw')
+     np.ones(n_voxels**3, dtype=np.uint8  ).tofile(material_path)
+     np.ones(n_voxels**3, dtype=np.float32).tofile(activity_path)
+
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction DefaultTrackingAction
+/nexus/RegisterSteppingAction PetSaveAllSteppingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name_voxel_phantom}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name_voxel_phantom+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 1
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+/Geometry/FullRingTiles/voxel_phantom true
+
+/Geometry/VoxelPhantom/material_file {material_path}
+/Geometry/VoxelPhantom/activity_file {activity_path}
+/Geometry/VoxelPhantom/n_voxels_x {n_voxels}
+/Geometry/VoxelPhantom/n_voxels_y {n_voxels}
+/Geometry/VoxelPhantom/n_voxels_z {n_voxels}
+/Geometry/VoxelPhantom/voxel_size 2.5 2.5 2.5 mm
+/Geometry/VoxelPhantom/add_material G4_AIR
+/Geometry/VoxelPhantom/add_material G4_WATER
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region VOXEL_PHANTOM
+
+/Actions/PetSaveAllSteppingAction/select_particle gamma
+
+/petalosim/persistency/output_file {output_tmpdir}/{base_name_voxel_phantom}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name_voxel_phantom+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '20', init_path]
+     p         = subprocess.run(command, check=True, env=my_env)
+
+
+@pytest.mark.order(12)
+def test_create_petalo_output_file_region_cuts(config_tmpdir, output_tmpdir, PETALODIR, base_name_region_cuts):
+     """
+     Job with a production cut configured only for the ACTIVE region,
+     whose output, with the dump of the regions, is saved to a log file.
+     """
+     init_text = f"""
+/PhysicsList/RegisterPhysics G4EmStandardPhysics_option4
+/PhysicsList/RegisterPhysics G4DecayPhysics
+/PhysicsList/RegisterPhysics G4RadioactiveDecayPhysics
+/PhysicsList/RegisterPhysics PetaloPhysics
+/PhysicsList/RegisterPhysics G4StepLimiterPhysics
+
+### GEOMETRY
+/nexus/RegisterGeometry FullRingTiles
+
+### GENERATOR
+/nexus/RegisterGenerator Back2backGammas
+
+### ACTIONS
+/nexus/RegisterRunAction DefaultRunAction
+/nexus/RegisterEventAction PetaloEventAction
+/nexus/RegisterTrackingAction DefaultTrackingAction
+
+/nexus/RegisterPersistencyManager PetaloPersistencyManager
+
+/nexus/RegisterMacro {config_tmpdir}/{base_name_region_cuts}.config.mac
+"""
+     init_path = os.path.join(config_tmpdir, base_name_region_cuts+'.init.mac')
+     init_file = open(init_path,'w')
+     init_file.write(init_text)
+     init_file.close()
+
+     config_text = f"""
+/run/verbose 2
+/event/verbose 0
+/tracking/verbose 0
+
+/process/em/verbose 0
+
+/Geometry/FullRingTiles/depth 3. cm
+/Geometry/FullRingTiles/inner_radius 165. mm
+/Geometry/FullRingTiles/tile_rows 2
+/Geometry/FullRingTiles/instrumented_faces 1
+
+/Geometry/SiPMpet/efficiency 0.2
+/Geometry/SiPMpet/size 3. mm
+
+/Generator/Back2back/region CENTER
+
+/run/setCut 2. mm
+/petalosim/regions/ACTIVE/production_cut 0.5 mm
+
+/petalosim/persistency/output_file {output_tmpdir}/{base_name_region_cuts}
+/nexus/random_seed 16062020
+
+"""
+
+     config_path = os.path.join(config_tmpdir, base_name_region_cuts+'.config.mac')
+     config_file = open(config_path,'w')
+     config_file.write(config_text)
+     config_file.close()
+
+     my_env    = os.environ
+     petalo_exe = PETALODIR + '/bin/petalo'
+     command   = [petalo_exe, '-b', '-n', '1', init_path]
+     log_path  = os.path.join(output_tmpdir, base_name_region_cuts+'.log')
+     with open(log_path, 'w') as log_file:
+          p = subprocess.run(command, check=True, env=my_env,
+                             stdout=log_file, stderr=subprocess.STDOUT)
+
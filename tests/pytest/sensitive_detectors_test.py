@@ -151,3 +151,61 @@ def test_sensor_ids_petit_saturation(output_tmpdir, petit_sat_params):
 
      assert 1 <= len(set(sipm_ids1)) <= nsipms / 2.
      assert 1 <= len(set(sipm_ids2)) <= nsipms / 2.
+
+
+def test_replica_sensors_positions(replica_file_names):
+     """
+     Check that the sensors built as replicas have the same IDs
+     and positions as the ones placed one by one.
+     """
+     file_placed, file_replica = replica_file_names
+
+     # The jobs save the positions of all the sensors,
+     # not only of those with charge
+     pos_placed  = pd.read_hdf(file_placed,  'MC/sns_positions')
+     pos_replica = pd.read_hdf(file_replica, 'MC/sns_positions')
+     pos_placed  = pos_placed .sort_values('sensor_id').reset_index(drop=True)
+     pos_replica = pos_replica.sort_values('sensor_id').reset_index(drop=True)
+
+     assert len(pos_placed) > 0
+     np.testing.assert_array_equal(pos_replica.sensor_id,   pos_placed.sensor_id)
+     np.testing.assert_array_equal(pos_replica.sensor_name, pos_placed.sensor_name)
+     for coord in ['x', 'y', 'z']:
+          np.testing.assert_allclose(pos_replica[coord], pos_placed[coord],
+                                     atol=1e-3)
+
+
+def test_geometry_cache_round_trip(file_names_geometry_cache, geometry_cache_dir):
+     """
+     Check that a geometry read from the cache has the same sensors,
+     and gives the same sensor response, as the geometry built
+     from scratch.
+     """
+     file_built, file_cached = file_names_geometry_cache
+
+     cached = [f for f in os.listdir(geometry_cache_dir) if f.endswith('.gdml')]
+     assert len(cached) == 1
+     assert cached[0].startswith('FullRingTiles_')
+
+     pos_built  = pd.read_hdf(file_built,  'MC/sns_positions')
+     pos_cached = pd.read_hdf(file_cached, 'MC/sns_positions')
+     pos_built  = pos_built .sort_values('sensor_id').reset_index(drop=True)
+     pos_cached = pos_cached.sort_values('sensor_id').reset_index(drop=True)
+
+     assert len(pos_built) > 0
+     np.testing.assert_array_equal(pos_cached.sensor_id,   pos_built.sensor_id)
+     np.testing.assert_array_equal(pos_cached.sensor_name, pos_built.sensor_name)
+     for coord in ['x', 'y', 'z']:
+          np.testing.assert_allclose(pos_cached[coord], pos_built[coord],
+                                     atol=1e-3)
+
+     # The sensitive detectors are attached again to the cached volumes
+     sns_built  = pd.read_hdf(file_built,  'MC/sns_response')
+     sns_cached = pd.read_hdf(file_cached, 'MC/sns_response')
+     assert len(sns_built) > 0
+     pd.testing.assert_frame_equal(sns_cached, sns_built)
+
+     hits_built  = pd.read_hdf(file_built,  'MC/hits')
+     hits_cached = pd.read_hdf(file_cached, 'MC/hits')
+     assert len(hits_built) > 0
+     pd.testing.assert_frame_equal(hits_cached, hits_built, check_exact=False)
@@ -1,6 +1,7 @@
 import pytest
 import os
 
+import numpy  as np
 import pandas as pd
 
 def test_vertices_are_generated_in_phantom(file_name_phantom):
@@ -15,3 +16,26 @@ def test_vertices_are_generated_in_phantom(file_name_phantom):
                        'SPHERE4', 'SPHERE5']
 
     assert all(elem in correct_volumes for elem in volumes)
+
+
+def test_annihilation_vertices_follow_positron_range(file_name_positron_range):
+    """Check that the back-to-back gammas are emitted at a distance from
+    the decay point sampled from the positron range table, and the prompt
+    gamma at the decay point itself"""
+
+    particles = pd.read_hdf(file_name_positron_range, 'MC/particles')
+    primaries = particles[(particles.primary == 1) & (particles.particle_name == 'gamma')]
+    assert len(primaries) > 0
+
+    # All the distances of the table are between 1 and 1.01 mm
+    prompt       = primaries[primaries.kin_energy >  1.]
+    annihilation = primaries[primaries.kin_energy <= 1.]
+    distance     = np.sqrt(annihilation.initial_x**2 +
+                           annihilation.initial_y**2 +
+                           annihilation.initial_z**2)
+
+    assert len(prompt) == len(primaries.event_id.unique())
+    assert np.allclose(prompt.kin_energy, 1.2745)
+    assert np.allclose(prompt[['initial_x', 'initial_y', 'initial_z']], 0.)
+    assert np.all((distance > 1. - 1e-4) & (distance < 1.01 + 1e-4))
+